@@ -0,0 +1,217 @@
+/***************************************************************************
+**                                                                        **
+**                     Connect-4 Batch Position Analyzer                  **
+**                                                                        **
+****************************************************************************
+**                                                                        **
+**  Reads positions, one move sequence per line, and writes the engine's  **
+**  choice for each of them without asking anything on the terminal.     **
+**                                                                        **
+**  usage: analyze <engine> <positions> <results> [threads [cache]]       **
+**                                                                        **
+**  <engine> is "depth:N" (search N plies), "time:MS" (iterative          **
+**  deepening for MS milliseconds) or "rule" (the rule-based player).     **
+**  A position is the list of columns played from the empty board,       **
+**  counted from 1, e.g. "4453"; the first player to move is player 0.   **
+**  A single "." is the empty board.  Empty lines and lines starting     **
+**  with '#' are skipped.  "-" reads stdin or writes stdout.              **
+**                                                                        **
+**  Each result line holds, separated by tabs,                            **
+**  the moves, the best column (from 1), the score for the player to      **
+**  move, the number of nodes searched and the time taken in ms.          **
+**  Positions that cannot be reached get "invalid" and positions where   **
+**  the game is already over get "finished" instead of a column.         **
+**  [cache] is a solved-position cache shared with other processes.      **
+**                                                                        **
+***************************************************************************/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include "c4.h"
+
+#define ANALYZE_HASH_MB 256
+
+#define ENGINE_DEPTH 0
+#define ENGINE_TIME  1
+#define ENGINE_RULE  2
+
+static bool setup_position(c4_ctx *ctx, const char *moves, int *player, bool *finished);
+static double elapsed_ms(const struct timespec *start);
+
+
+
+int
+main(int argc, char *argv[])
+{
+	char line[256], *moves, *end;
+	int engine, limit = 0, threads = 1, player, column, row, goodness, depth, i;
+	bool finished;
+	unsigned long nodes, total_nodes = 0, positions = 0;
+	double ms, total_ms = 0;
+	struct timespec start;
+	c4_ctx *ctx;
+	FILE *input, *output;
+
+	if (argc < 4 || argc > 6) {
+		fprintf(stderr, "usage: %s <depth:N | time:MS | rule> <positions> <results> [threads [cache]]\n", argv[0]);
+		return 2;
+	}
+	if (sscanf(argv[1], "depth:%d", &limit) == 1 && limit >= 1 && limit <= C4_MAX_LEVEL)
+		engine = ENGINE_DEPTH;
+	else if (sscanf(argv[1], "time:%d", &limit) == 1 && limit >= 1)
+		engine = ENGINE_TIME;
+	else if (strcmp(argv[1], "rule") == 0)
+		engine = ENGINE_RULE;
+	else {
+		fprintf(stderr, "%s: engine must be depth:1-%d, time:<ms> or rule.\n", argv[0], C4_MAX_LEVEL);
+		return 2;
+	}
+	if (argc >= 5)
+		threads = atoi(argv[4]);
+	if (threads < 1 || threads > C4_MAX_THREADS) {
+		fprintf(stderr, "%s: threads must be 1-%d.\n", argv[0], C4_MAX_THREADS);
+		return 2;
+	}
+
+	input = strcmp(argv[2], "-") == 0 ? stdin : fopen(argv[2], "r");
+	if (input == NULL) {
+		perror(argv[2]);
+		return 1;
+	}
+	output = strcmp(argv[3], "-") == 0 ? stdout : fopen(argv[3], "w");
+	if (output == NULL) {
+		perror(argv[3]);
+		return 1;
+	}
+
+	ctx = c4_ctx_new();
+	c4_ctx_set_hash_size(ctx, ANALYZE_HASH_MB);
+	c4_ctx_set_threads(ctx, threads);
+	if (engine == ENGINE_RULE)
+		c4_ctx_set_engine(ctx, C4_ENGINE_RULE);
+	if (argc == 6 && !c4_ctx_open_solved_cache(ctx, argv[5], 0)) {
+		fprintf(stderr, "%s: can't open solved cache %s.\n", argv[0], argv[5]);
+		return 1;
+	}
+
+	fprintf(output, "# moves\tcolumn\tscore\tnodes\tms\n");
+	while (fgets(line, sizeof(line), input) != NULL) {
+		/* ʹ     invalid óѴ. */
+		if (strchr(line, '\n') == NULL && !feof(input)) {
+			int ch;
+			while ((ch = getc(input)) != EOF && ch != '\n')
+				;
+			line[0] = '?';
+			line[1] = '\0';
+		}
+		for (moves = line; *moves == ' ' || *moves == '\t'; moves++)
+			;
+		for (end = moves + strlen(moves); end > moves && strchr(" \t\r\n", end[-1]) != NULL; end--)
+			;
+		*end = '\0';
+		if (*moves == '#' || *moves == '\0')
+			continue;
+
+		if (!setup_position(ctx, strcmp(moves, ".") == 0 ? "" : moves, &player, &finished)) {
+			fprintf(output, "%s\tinvalid\t-\t-\t-\n", moves);
+			c4_ctx_end_game(ctx);
+			continue;
+		}
+		if (finished) {
+			fprintf(output, "%s\tfinished\t-\t-\t-\n", moves);
+			c4_ctx_end_game(ctx);
+			continue;
+		}
+
+		timespec_get(&start, TIME_UTC);
+		nodes = 0;
+		if (engine == ENGINE_RULE) {
+			/* column row  ޴´.     ʴ´. */
+			c4_ctx_auto_move(ctx, player, 1, &column, &row);
+			ms = elapsed_ms(&start);
+			fprintf(output, "%s\t%d\t-\t0\t%.3f\n", moves, column + 1, ms);
+		}
+		else {
+			if (engine == ENGINE_DEPTH)
+				column = c4_ctx_search(ctx, player, limit, &goodness);
+			else
+				column = c4_ctx_search_timed(ctx, player, limit, &goodness, &depth);
+			ms = elapsed_ms(&start);
+			for (i = 0; i < threads; i++)
+				nodes += c4_ctx_thread_nodes(ctx, i);
+			fprintf(output, "%s\t%d\t%d\t%lu\t%.3f\n", moves, column + 1, goodness, nodes, ms);
+		}
+		c4_ctx_end_game(ctx);
+
+		positions++;
+		total_nodes += nodes;
+		total_ms += ms;
+	}
+
+	if (input != stdin)
+		fclose(input);
+	if (fflush(output) != 0 || (output != stdout && fclose(output) != 0)) {
+		perror(argv[3]);
+		return 1;
+	}
+	c4_ctx_free(ctx);
+
+	fprintf(stderr, "%lu positions, %lu nodes, %.0f ms", positions, total_nodes, total_ms);
+	if (total_ms > 0)
+		fprintf(stderr, ", %.0f nodes/s", total_nodes * 1000.0 / total_ms);
+	fprintf(stderr, "\n");
+	return 0;
+}
+
+
+
+/**
+* @function setup_position
+*
+* @param moves  忡  column. 1 .
+* @param player    player  
+* @param finished    ٸ true  
+* @return moves   ־ٸ true,  column̰ų   column̰ų  ӿ  Ҵٸ false
+*
+* ctx   ϰ moves  player 0  ´.  column     row Ѵ.
+*/
+
+static bool
+setup_position(c4_ctx *ctx, const char *moves, int *player, bool *finished)
+{
+	int height[WIDTH] = { 0 }, column, i;
+
+	c4_ctx_new_game(ctx);
+	*finished = false;
+	for (i = 0; moves[i] != '\0'; i++) {
+		column = moves[i] - '1';
+		if (*finished || column < 0 || column >= WIDTH || height[column] == HEIGHT)
+			return false;
+		c4_ctx_make_move(ctx, i & 1, column, height[column]++);
+		*finished = c4_ctx_is_winner(ctx, i & 1) || c4_ctx_is_tie(ctx);
+	}
+	*player = i & 1;
+	return true;
+}
+
+
+
+/**
+* @function elapsed_ms
+*
+* @return start ݱ 帥 ð(и)
+*/
+
+static double
+elapsed_ms(const struct timespec *start)
+{
+	struct timespec now;
+
+	timespec_get(&now, TIME_UTC);
+	return (now.tv_sec - start->tv_sec) * 1000.0 + (now.tv_nsec - start->tv_nsec) / 1e6;
+}
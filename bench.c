@@ -0,0 +1,274 @@
+/***************************************************************************
+**                                                                        **
+**                        Connect-4 Search Benchmark                      **
+**                                                                        **
+****************************************************************************
+**                                                                        **
+**  Searches every position of a fixed set at a fixed depth and reports   **
+**  the nodes searched, the speed and a signature of the node counts.     **
+**                                                                        **
+**  usage: bench [depth [positions [text|csv|json]]]                      **
+**                                                                        **
+**  The default is depth 10 over "bench.txt", which holds 300 positions   **
+**  from the opening, the middle game and the endgame in the format read  **
+**  by analyze.c.                                                         **
+**                                                                        **
+**  Every position is searched by a new c4_ctx with one thread, so the    **
+**  nodes searched do not depend on the order of the positions or on the  **
+**  machine.  The signature is a hash of the column chosen and the nodes  **
+**  searched for every position: a change that is meant to make the       **
+**  search faster without changing it must keep the signature, and any    **
+**  change to the evaluation or the move ordering changes it.             **
+**                                                                        **
+**  "csv" and "json" also list every position, for charting by commit.   **
+**                                                                        **
+***************************************************************************/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include "c4.h"
+
+#define BENCH_HASH_MB   16
+#define BENCH_DEPTH     10
+#define BENCH_POSITIONS "bench.txt"
+#define MAX_POSITIONS   1000
+
+#define FORMAT_TEXT 0
+#define FORMAT_CSV  1
+#define FORMAT_JSON 2
+
+#define FNV_OFFSET 0xCBF29CE484222325ULL
+#define FNV_PRIME  0x100000001B3ULL
+
+/**
+* Result ü  ϳ Ž ̴.
+*/
+
+typedef struct {
+
+	char moves[WIDTH * HEIGHT + 1];	//  忡  column. 1 .
+
+	int column;         	//  column. 0 .
+
+	unsigned long nodes;
+
+	double ms;
+
+} Result;
+
+static Result results[MAX_POSITIONS];
+
+static int read_positions(const char *path);
+static bool setup_position(c4_ctx *ctx, const char *moves, int *player);
+static uint64_t hash_value(uint64_t hash, uint64_t value);
+static double elapsed_ms(const struct timespec *start);
+
+
+
+int
+main(int argc, char *argv[])
+{
+	const char *path = BENCH_POSITIONS;
+	int depth = BENCH_DEPTH, format = FORMAT_TEXT, count, player, row, i;
+	unsigned long total_nodes = 0;
+	double total_ms = 0, nps;
+	uint64_t signature = FNV_OFFSET;
+	struct timespec start;
+	c4_ctx *ctx;
+
+	if (argc > 4) {
+		fprintf(stderr, "usage: %s [depth [positions [text|csv|json]]]\n", argv[0]);
+		return 2;
+	}
+	if (argc >= 2)
+		depth = atoi(argv[1]);
+	if (argc >= 3)
+		path = argv[2];
+	if (argc >= 4) {
+		if (strcmp(argv[3], "csv") == 0)
+			format = FORMAT_CSV;
+		else if (strcmp(argv[3], "json") == 0)
+			format = FORMAT_JSON;
+		else if (strcmp(argv[3], "text") != 0) {
+			fprintf(stderr, "%s: format must be text, csv or json.\n", argv[0]);
+			return 2;
+		}
+	}
+	if (depth < 1 || depth > C4_MAX_LEVEL) {
+		fprintf(stderr, "%s: depth must be 1-%d.\n", argv[0], C4_MAX_LEVEL);
+		return 2;
+	}
+
+	count = read_positions(path);
+	if (count < 0)
+		return 1;
+
+	for (i = 0; i < count; i++) {
+		ctx = c4_ctx_new();
+		c4_ctx_set_hash_size(ctx, BENCH_HASH_MB);
+		if (!setup_position(ctx, results[i].moves, &player)) {
+			fprintf(stderr, "%s: line %d of %s is not a position where a piece can be dropped: %s\n",
+				argv[0], i + 1, path, results[i].moves);
+			return 1;
+		}
+
+		timespec_get(&start, TIME_UTC);
+		c4_ctx_auto_move(ctx, player, depth, &results[i].column, &row);
+		results[i].ms = elapsed_ms(&start);
+		results[i].nodes = c4_ctx_thread_nodes(ctx, 0);
+		c4_ctx_end_game(ctx);
+		c4_ctx_free(ctx);
+
+		total_nodes += results[i].nodes;
+		total_ms += results[i].ms;
+		signature = hash_value(hash_value(signature, (uint64_t)results[i].column), results[i].nodes);
+	}
+	nps = total_ms > 0 ? total_nodes * 1000.0 / total_ms : 0;
+
+	if (format == FORMAT_CSV) {
+		printf("moves,column,nodes,ms\n");
+		for (i = 0; i < count; i++)
+			printf("%s,%d,%lu,%.3f\n", results[i].moves, results[i].column + 1, results[i].nodes, results[i].ms);
+		printf("total,%016llx,%lu,%.3f\n", (unsigned long long)signature, total_nodes, total_ms);
+	}
+	else if (format == FORMAT_JSON) {
+		printf("{\n  \"depth\": %d,\n  \"positions\": %d,\n  \"nodes\": %lu,\n  \"ms\": %.3f,\n"
+			"  \"nps\": %.0f,\n  \"signature\": \"%016llx\",\n  \"results\": [\n",
+			depth, count, total_nodes, total_ms, nps, (unsigned long long)signature);
+		for (i = 0; i < count; i++)
+			printf("    { \"moves\": \"%s\", \"column\": %d, \"nodes\": %lu, \"ms\": %.3f }%s\n",
+				results[i].moves, results[i].column + 1, results[i].nodes, results[i].ms, i + 1 < count ? "," : "");
+		printf("  ]\n}\n");
+	}
+	else {
+		printf("positions  %d\n", count);
+		printf("depth      %d\n", depth);
+		printf("nodes      %lu\n", total_nodes);
+		printf("time       %.0f ms\n", total_ms);
+		printf("nodes/s    %.0f\n", nps);
+		printf("signature  %016llx\n", (unsigned long long)signature);
+	}
+	return 0;
+}
+
+
+
+/**
+* @function read_positions
+*
+* @param path   
+* @return   .    ٸ -1
+*
+* analyze.c     results д´.  ٰ '#' ϴ  ǳʶٰ,
+*   "." .  stderr ˸.
+*/
+
+static int
+read_positions(const char *path)
+{
+	char line[256], *moves, *end;
+	int count = 0;
+	FILE *input;
+
+	input = fopen(path, "r");
+	if (input == NULL) {
+		perror(path);
+		return -1;
+	}
+	while (fgets(line, sizeof(line), input) != NULL) {
+		for (moves = line; *moves == ' ' || *moves == '\t'; moves++)
+			;
+		for (end = moves + strlen(moves); end > moves && strchr(" \t\r\n", end[-1]) != NULL; end--)
+			;
+		*end = '\0';
+		if (*moves == '#' || *moves == '\0')
+			continue;
+		if (strcmp(moves, ".") == 0)
+			*moves = '\0';
+
+		if (count == MAX_POSITIONS || strlen(moves) > WIDTH * HEIGHT) {
+			fprintf(stderr, "%s: more than %d positions or a position longer than %d moves.\n",
+				path, MAX_POSITIONS, WIDTH * HEIGHT);
+			fclose(input);
+			return -1;
+		}
+		strcpy(results[count++].moves, moves);
+	}
+	fclose(input);
+	return count;
+}
+
+
+
+/**
+* @function setup_position
+*
+* @param moves  忡  column. 1 .
+* @param player    player  
+* @return moves   ־   ʾҴٸ true
+*
+* ctx   ϰ moves  player 0  ´.
+*/
+
+static bool
+setup_position(c4_ctx *ctx, const char *moves, int *player)
+{
+	int height[WIDTH] = { 0 }, column, i;
+
+	c4_ctx_new_game(ctx);
+	for (i = 0; moves[i] != '\0'; i++) {
+		column = moves[i] - '1';
+		if (column < 0 || column >= WIDTH || height[column] == HEIGHT)
+			return false;
+		c4_ctx_make_move(ctx, i & 1, column, height[column]++);
+		if (c4_ctx_is_winner(ctx, i & 1) || c4_ctx_is_tie(ctx))
+			return false;
+	}
+	*player = i & 1;
+	return true;
+}
+
+
+
+/**
+* @function hash_value
+*
+* @param hash ݱ hash
+* @param value  
+* @return value 8Ʈ ʷ  FNV-1a hash
+*/
+
+static uint64_t
+hash_value(uint64_t hash, uint64_t value)
+{
+	int i;
+
+	for (i = 0; i < 8; i++) {
+		hash = (hash ^ (value & 0xFF)) * FNV_PRIME;
+		value >>= 8;
+	}
+	return hash;
+}
+
+
+
+/**
+* @function elapsed_ms
+*
+* @return start ݱ 帥 ð(и)
+*/
+
+static double
+elapsed_ms(const struct timespec *start)
+{
+	struct timespec now;
+
+	timespec_get(&now, TIME_UTC);
+	return (now.tv_sec - start->tv_sec) * 1000.0 + (now.tv_nsec - start->tv_nsec) / 1e6;
+}
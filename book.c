@@ -0,0 +1,470 @@
+/***************************************************************************
+**                                                                        **
+**                     Connect-4 Opening Book Generator                   **
+**                                                                        **
+****************************************************************************
+**                                                                        **
+**  Searches every position with fewer than <plies> pieces on the board  **
+**  at the given level and writes the best column for each one to an     **
+**  opening book that c4_load_book() can map into memory.                 **
+**                                                                        **
+**  usage: book <book file> <plies> <level> [threads]                     **
+**                                                                        **
+**  Every finished position is appended to "<book file>.part" as soon as  **
+**  it is searched, so the program can be stopped at any time and run     **
+**  again with the same arguments to continue where it left off.  The     **
+**  book itself is written when all positions are done.  Progress is      **
+**  printed on stderr.                                                    **
+**                                                                        **
+***************************************************************************/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "c4.h"
+
+#ifdef _WIN32
+#include <io.h>
+#define fileno    _fileno
+#define ftruncate _chsize_s
+#define fsync     _commit
+#else
+#include <unistd.h>
+#endif
+
+#define MAX_PLIES    16	// ̺  book   ʹ 
+#define BOOK_HASH_MB 256
+#define JOURNAL_SYNC 256	// ̸ŭ   journal ũ fsync()Ѵ
+
+/**
+* Line ü  忡  鿡 ̸  Ÿ.
+*/
+
+typedef struct {
+
+	signed char first;          	//   player
+
+	signed char moves[MAX_PLIES];	// ʴ  column
+
+} Line;
+
+/**
+* Key_set ü position key ̴. 0  ĭ Ѵ(c4_position_key() 0  ʴ´).
+*/
+
+typedef struct {
+
+	uint64_t *keys;
+
+	size_t size, count;     	// size ׻ 2 ŵ
+
+} Key_set;
+
+static bool key_set_add(Key_set *set, uint64_t key);
+static bool key_set_has(const Key_set *set, uint64_t key);
+static void replay(c4_ctx *ctx, const Line *line, int length);
+static int column_height(const Line *line, int length, int column);
+static size_t read_journal(const char *path, int level, c4_book_entry **entries, Key_set *done, size_t *records);
+static FILE *open_journal(const char *path, size_t records);
+static bool write_book(const char *path, c4_book_entry *entries, size_t count, int plies, int level);
+static int compare_entries(const void *a, const void *b);
+static void *emalloc(size_t size);
+
+
+
+int
+main(int argc, char *argv[])
+{
+	char journal_path[1024];
+	int plies, level, threads = 1, ply, column, player, goodness;
+	c4_ctx *ctx;
+	FILE *journal;
+	Key_set seen = { NULL, 0, 0 }, done = { NULL, 0, 0 };
+	c4_book_entry *entries, entry;
+	size_t num_entries, capacity, records, frontier_size, next_size, i, searched;
+	Line *frontier, *next, child;
+	uint64_t key;
+	bool mirrored;
+
+	if (argc < 4 || argc > 5) {
+		fprintf(stderr, "usage: %s <book file> <plies> <level> [threads]\n", argv[0]);
+		return 2;
+	}
+	plies = atoi(argv[2]);
+	level = atoi(argv[3]);
+	if (argc == 5)
+		threads = atoi(argv[4]);
+	if (plies < 1 || plies > MAX_PLIES || level < 1 || level > C4_MAX_LEVEL || threads < 1 || threads > C4_MAX_THREADS) {
+		fprintf(stderr, "%s: plies must be 1-%d, level 1-%d and threads 1-%d.\n", argv[0], MAX_PLIES, C4_MAX_LEVEL, C4_MAX_THREADS);
+		return 2;
+	}
+	snprintf(journal_path, sizeof(journal_path), "%s.part", argv[1]);
+
+	/*  ࿡   о , journal  ߸ ϸ ߶   ̾ . */
+
+	num_entries = read_journal(journal_path, level, &entries, &done, &records);
+	capacity = num_entries;
+	journal = open_journal(journal_path, records);
+	if (journal == NULL) {
+		perror(journal_path);
+		return 1;
+	}
+	fprintf(stderr, "%s: %lu positions already searched\n", journal_path, (unsigned long)num_entries);
+	if (records > num_entries)
+		fprintf(stderr, "%s: %lu records of another level or repeated are kept but not used\n",
+			journal_path, (unsigned long)(records - num_entries));
+
+	ctx = c4_ctx_new();
+	c4_ctx_set_hash_size(ctx, BOOK_HASH_MB);
+	c4_ctx_set_threads(ctx, threads);
+
+	/*  忡    , ¿ Ī  ó  鸸 ŽѴ. */
+	/*  ϼ  Ƿ  .                                  */
+
+	frontier = (Line *)emalloc(2 * sizeof(Line));
+	frontier_size = 0;
+	for (player = 0; player < 2; player++) {
+		frontier[frontier_size].first = (signed char)player;
+		replay(ctx, &frontier[frontier_size], 0);
+		key_set_add(&seen, c4_ctx_position_key(ctx, player, NULL));
+		c4_ctx_end_game(ctx);
+		frontier_size++;
+	}
+
+	for (ply = 0; ply < plies; ply++) {
+		next = (Line *)emalloc((frontier_size * WIDTH + 1) * sizeof(Line));
+		next_size = 0;
+		searched = 0;
+
+		for (i = 0; i < frontier_size; i++) {
+			player = frontier[i].first ^ (ply & 1);
+			replay(ctx, &frontier[i], ply);
+			key = c4_ctx_position_key(ctx, player, &mirrored);
+
+			if (!key_set_has(&done, key)) {
+				column = c4_ctx_search(ctx, player, level, &goodness);
+				if (column >= 0) {
+					memset(&entry, 0, sizeof(entry));
+					entry.key = key;
+					entry.goodness = goodness;
+					entry.column = (uint8_t)(mirrored ? WIDTH - 1 - column : column);
+					entry.level = (uint8_t)level;
+					if (fwrite(&entry, sizeof(entry), 1, journal) != 1 || fflush(journal) != 0 ||
+						(++records % JOURNAL_SYNC == 0 && fsync(fileno(journal)) != 0)) {
+						perror(journal_path);
+						return 1;
+					}
+					if (num_entries == capacity) {
+						capacity = capacity * 2 + 64;
+						entries = (c4_book_entry *)realloc(entries, capacity * sizeof(c4_book_entry));
+						if (entries == NULL) {
+							fprintf(stderr, "%s: out of memory.\n", argv[0]);
+							return 1;
+						}
+					}
+					entries[num_entries++] = entry;
+					key_set_add(&done, key);
+				}
+				searched++;
+			}
+			c4_ctx_end_game(ctx);
+
+			if (ply + 1 == plies)
+				continue;
+
+			/*       ó  ͸  ܰ迡 ִ´. */
+			for (column = 0; column < WIDTH; column++) {
+				if (column_height(&frontier[i], ply, column) == HEIGHT)
+					continue;
+				child = frontier[i];
+				child.moves[ply] = (signed char)column;
+				replay(ctx, &child, ply + 1);
+				if (!c4_ctx_is_winner(ctx, 0) && !c4_ctx_is_winner(ctx, 1) &&
+					key_set_add(&seen, c4_ctx_position_key(ctx, player ^ 1, NULL)))
+					next[next_size++] = child;
+				c4_ctx_end_game(ctx);
+			}
+		}
+
+		if (fsync(fileno(journal)) != 0) {
+			perror(journal_path);
+			return 1;
+		}
+		fprintf(stderr, "ply %d: %lu positions, %lu searched\n", ply, (unsigned long)frontier_size, (unsigned long)searched);
+		free(frontier);
+		frontier = next;
+		frontier_size = next_size;
+	}
+
+	fclose(journal);
+	c4_ctx_free(ctx);
+
+	if (!write_book(argv[1], entries, num_entries, plies, level)) {
+		perror(argv[1]);
+		return 1;
+	}
+	fprintf(stderr, "%s: %lu positions\n", argv[1], (unsigned long)num_entries);
+	return 0;
+}
+
+
+
+/**
+* @function replay
+*
+* @param line  
+* @param length line   
+*
+* ctx   ϰ line ù length  ´.  column     row Ѵ.
+*/
+
+static void
+replay(c4_ctx *ctx, const Line *line, int length)
+{
+	int height[WIDTH] = { 0 }, i, column;
+
+	c4_ctx_new_game(ctx);
+	for (i = 0; i < length; i++) {
+		column = line->moves[i];
+		c4_ctx_make_move(ctx, line->first ^ (i & 1), column, height[column]++);
+	}
+}
+
+
+
+/**
+* @function column_height
+*
+* @return line ù length    column   
+*/
+
+static int
+column_height(const Line *line, int length, int column)
+{
+	int i, height = 0;
+
+	for (i = 0; i < length; i++)
+		if (line->moves[i] == column)
+			height++;
+	return height;
+}
+
+
+
+/**
+* @function read_journal
+*
+* @param path journal  
+* @param level ̹  Ž . ٸ ̷ Ž    Ͽ  д.
+* @param entries   迭  
+* @param done   key  
+* @param records Ͽ      
+* @return   
+*
+*    ߿ ٸ  ߸  Ѵ.  ٸ 0 Ѵ.
+*/
+
+static size_t
+read_journal(const char *path, int level, c4_book_entry **entries, Key_set *done, size_t *records)
+{
+	FILE *file = fopen(path, "rb");
+	size_t count = 0, capacity = 64;
+	c4_book_entry entry;
+
+	*entries = (c4_book_entry *)emalloc(capacity * sizeof(c4_book_entry));
+	*records = 0;
+	if (file == NULL)
+		return 0;
+
+	while (fread(&entry, sizeof(entry), 1, file) == 1) {
+		(*records)++;
+		if (entry.level != level || !key_set_add(done, entry.key))
+			continue;
+		if (count == capacity) {
+			capacity *= 2;
+			*entries = (c4_book_entry *)realloc(*entries, capacity * sizeof(c4_book_entry));
+			if (*entries == NULL) {
+				fprintf(stderr, "book: out of memory.\n");
+				exit(1);
+			}
+		}
+		(*entries)[count++] = entry;
+	}
+	fclose(file);
+	return count;
+}
+
+
+
+/**
+* @function open_journal
+*
+* @param path journal  
+* @param records read_journal() , Ͽ    
+* @return  ̾   journal. ߴٸ NULL
+*
+*  ߸ ϸ ߶    ٽ  Ƿ,  ߿ ߾    ʴ´.
+*/
+
+static FILE *
+open_journal(const char *path, size_t records)
+{
+	FILE *file = fopen(path, "r+b");
+
+	if (file != NULL) {
+		if (ftruncate(fileno(file), records * sizeof(c4_book_entry)) != 0) {
+			fclose(file);
+			return NULL;
+		}
+		fclose(file);
+	}
+	return fopen(path, "ab");
+}
+
+
+
+/**
+* @function write_book
+*
+* @param path book  
+* @param entries book  ϵ. key  ĵȴ.
+* @param count  
+* @return ߴٸ true
+*
+* ٸ process mmap() а   Ƿ, ӽ Ͽ    ̸ ٲپ   üѴ.
+*/
+
+static bool
+write_book(const char *path, c4_book_entry *entries, size_t count, int plies, int level)
+{
+	char temp_path[1024];
+	c4_book_header header;
+	FILE *file;
+
+	qsort(entries, count, sizeof(c4_book_entry), compare_entries);
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, C4_BOOK_MAGIC, sizeof(header.magic));
+	header.version = C4_BOOK_VERSION;
+	header.width = WIDTH;
+	header.height = HEIGHT;
+	header.plies = (uint32_t)plies;
+	header.level = (uint32_t)level;
+	header.count = count;
+
+	snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+	file = fopen(temp_path, "wb");
+	if (file == NULL)
+		return false;
+	if (fwrite(&header, sizeof(header), 1, file) != 1 ||
+		fwrite(entries, sizeof(c4_book_entry), count, file) != count) {
+		fclose(file);
+		return false;
+	}
+	if (fclose(file) != 0)
+		return false;
+#ifdef _WIN32
+	remove(path); /* Windows rename() ̹ ִ   ʴ´. */
+#endif
+	return rename(temp_path, path) == 0;
+}
+
+
+
+/**
+* @function compare_entries
+*
+* qsort() c4_book_entry key  ϱ   Լ̴.
+*/
+
+static int
+compare_entries(const void *a, const void *b)
+{
+	uint64_t x = ((const c4_book_entry *)a)->key, y = ((const c4_book_entry *)b)->key;
+
+	return (x > y) - (x < y);
+}
+
+
+
+/**
+* @function key_set_add
+*
+* @param set key  
+* @param key  key. 0 ƴϾ Ѵ.
+* @return key  ٸ true, ̹ ־ٸ false
+*
+* ĭ  ̻    ø.
+*/
+
+static bool
+key_set_add(Key_set *set, uint64_t key)
+{
+	size_t i, old_size = set->size;
+	uint64_t *old_keys = set->keys;
+
+	if (key_set_has(set, key))
+		return false;
+
+	if (2 * (set->count + 1) > set->size) {
+		set->size = old_size ? old_size * 2 : 1024;
+		set->keys = (uint64_t *)emalloc(set->size * sizeof(uint64_t));
+		memset(set->keys, 0, set->size * sizeof(uint64_t));
+		set->count = 0;
+		for (i = 0; i < old_size; i++)
+			if (old_keys[i] != 0)
+				key_set_add(set, old_keys[i]);
+		free(old_keys);
+	}
+
+	for (i = key & (set->size - 1); set->keys[i] != 0; i = (i + 1) & (set->size - 1))
+		;
+	set->keys[i] = key;
+	set->count++;
+	return true;
+}
+
+
+
+/**
+* @function key_set_has
+*
+* @return set key ִٸ true
+*/
+
+static bool
+key_set_has(const Key_set *set, uint64_t key)
+{
+	size_t i;
+
+	if (set->size == 0)
+		return false;
+	for (i = key & (set->size - 1); set->keys[i] != 0; i = (i + 1) & (set->size - 1))
+		if (set->keys[i] == key)
+			return true;
+	return false;
+}
+
+
+
+/**
+* @function emalloc
+*
+* malloc() , ޸𸮰 ϸ α׷ .
+*/
+
+static void *
+emalloc(size_t size)
+{
+	void *ptr = malloc(size);
+
+	if (ptr == NULL) {
+		fprintf(stderr, "book: out of memory.\n");
+		exit(1);
+	}
+	return ptr;
+}
@@ -40,11 +40,34 @@
 #include <string.h>
 #include <limits.h>
 #include <assert.h>
+#include <errno.h>
 #include <time.h>
 #include <math.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <threads.h>
 #include "c4.h"
 
+#ifdef _WIN32
+#define HAVE_MMAP 0
+#else
+#define HAVE_MMAP 1
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define HAVE_X86_SIMD
+#endif
+
+#if WIDTH * (HEIGHT + 1) > 64 || NUM_TO_CONNECT != 4
+#error "c4.c Ʈ (HEIGHT + 1) * WIDTH <= 64  Connect-4 Ѵ."
+#endif
+
 /**
 * Ǹ  ũ
 */
@@ -52,17 +75,45 @@
 #define other(x)    	((x) ^ 1) // 
 #define real_player(x)  ((x) & 1)
 
-#define pop_state() (current_state = &state_stack[--depth])
+/**
+* Ʈ ũ
+*
+* (column, row) ĭ column * COLUMN_BITS + row ° Ʈ Ѵ.
+*  column   ִ sentinel Ʈ ϳ ־,
+* shift    column ̷  ̾ ʴ´.
+*/
+
+#define COLUMN_BITS         (HEIGHT + 1)
+#define bottom_mask(col)    ((uint64_t)1 << ((col) * COLUMN_BITS))
+#define top_mask(col)       ((uint64_t)1 << ((HEIGHT - 1) + (col) * COLUMN_BITS))
+#define column_mask(col)    ((((uint64_t)1 << HEIGHT) - 1) << ((col) * COLUMN_BITS))
+#define cell_mask(col, row) ((uint64_t)1 << ((col) * COLUMN_BITS + (row)))
+#define mirror_column(col)  (WIDTH - 1 - (col))
+#define player_bits(state, player) \
+	((player) == 0 ? (state)->position : (state)->position ^ (state)->mask)
+
+/* num_of_win_places(WIDTH, HEIGHT, NUM_TO_CONNECT)  . score_array Game_state ȿ α   ð Ѵ. */
+#define WIN_PLACES (4 * WIDTH * HEIGHT - 3 * WIDTH * NUM_TO_CONNECT - 3 * HEIGHT * NUM_TO_CONNECT \
+	+ 3 * WIDTH + 3 * HEIGHT - 4 * NUM_TO_CONNECT + 2 * NUM_TO_CONNECT * NUM_TO_CONNECT + 2)
 
 
 
 /**
-*  ¿  Ư player "goodness" ڽ score
+*  ¿  Ư player "goodness" ڽ score
 *  score  ̴. goodness  , ش player
 * ڽ 溸   Ȳ ִٴ  Ѵ.
 */
 
-#define goodness_of(player) (current_state->score[player] - current_state->score[other(player)])
+/*
+* score_array  player з SIMD  (32Ʈ)  ÷ д.
+* þ ĭ  win place  Ƿ ׻ 0̴.
+*/
+
+#define SCORE_LANES      32
+#define SCORE_STRIDE     ((WIN_PLACES + SCORE_LANES - 1) / SCORE_LANES * SCORE_LANES)
+#define SCORE_MASK_WORDS (SCORE_STRIDE / 32)
+
+#define goodness_of(state, player) ((state)->score[player] - (state)->score[other(player)])
 
 
 
@@ -72,11 +123,15 @@
 
 typedef struct {
 
-	char **board;       	//  带 ǥϱ   迭. ,  0 . 
-							// C4_NONE ä  ĭ, 0̸ , 1̸ ǻ.
+	uint64_t position;  	// player 0()   ĭ Ʈ.
+							// player 1(ǻ)  position ^ mask Ѵ.
+
+	uint64_t mask;      	//    ĭ Ʈ. ,  0 .
 
-	int *(score_array[2]);	//  Winning Positions  player 0 1 score   迭
+	_Alignas(16) int8_t score_array[2][SCORE_STRIDE];	//  Winning Positions  player 0 1 score   迭
+							//  0 Ǵ 1, 2, 4, 8, 16̹Ƿ int8_t ϴ.
 							// Player 0, 1  ü ǥϱ  2 迭 Ͽ.
+							// ü ȿ ξ Game_state ϸ score_array Բ ȴ.
 
 	int score[2];       	// score_array   ִ  player score 
 							// player x score  score_array[x]   ̴.
@@ -86,841 +141,4151 @@ typedef struct {
 
 	int num_of_pieces;  	//        
 
+	uint64_t hash;      	//   Zobrist hash. drop_piece() undo_piece() Ѵ.
+
+	uint64_t hash_mirror;	// 带 ¿   Zobrist hash
+
 } Game_state;
 
 
 
 /**
-* Static global variables
+* Undo_record ü drop_piece() ٲ  undo_piece() ǵ  ֵ Ѵ.
+*   map[column][row] win place鿡  ڽ score_array   谡 ǰ
+*   0 ǹǷ, ڽ  ٽ   ǰ    θ ȴ.
 */
 
-static int size_x, size_y, total_size;
-static int num_to_connect;
-static int win_places;
+#define MAX_LINES_PER_CELL (NUM_TO_CONNECT * 4)
+
+typedef struct {
 
-static int ***map;  // map[x][y] win place ε ̷ 迭, -1 
+	uint64_t move;      	//   Ʈ
 
-static int magic_win_number;
-static bool game_in_progress = false, move_in_progress = false;
-static bool seed_chosen = false;
-static void(*poll_function)(void) = NULL;
-static clock_t poll_interval, next_poll;
-static Game_state state_stack[C4_MAX_LEVEL + 1]; //  21 迭
-static Game_state *current_state;
-static int depth;
-static int states_allocated = 0;
-static int *drop_order;
+	int score[2];       	//    score 
+
+	short int winner;   	//    winner
+
+	char player, column, row;
+
+	char other_scores[MAX_LINES_PER_CELL];	//   , map[column][row]  win place   score_array 
+
+} Undo_record;
 
 
 
 /**
-* A declaration of the local functions.
+* Search_context ü  thread Žϴ  ʿ  ¸ ´.
+* thread ڽ Search_context Ƿ,  thread  带 ǵ帮 ʰ ÿ Ž  ִ.
 */
 
-static int num_of_win_places(int x, int y, int n);
-static void update_score(int player, int x, int y);
-static int drop_piece(int player, int column);
-static void push_state(void);
-static int evaluate(int player, int level, int alpha, int beta);
-static void *emalloc(size_t size);
+typedef struct {
+
+	Game_state state;   	// Ž  . Ž     ¸ Ѵ.
+
+	Undo_record undo_log[WIDTH * HEIGHT];	// undo_log[n] n°   
+
+	int depth;          	//  Ž     . Ž ߿ rootκ .
+
+	unsigned long tt_hits, tt_misses, tt_collisions;	// search_root()   ü 迡 Ѵ.
+
+	unsigned long nodes;	// ̹  鼭 evaluate() solve() θ Ƚ
+
+	unsigned long cutoffs, first_move_cutoffs;	// evaluate() beta cutoff Ƚ  ù  Ͼ Ƚ.
+							// search_root()   ü 迡 Ѵ.
+
+	unsigned long interior_nodes;	// nodes    Ž  .  leaf̴.
+
+	unsigned long ply_nodes[WIDTH * HEIGHT + 1];	// ply_nodes[d] rootκ d Ʒ Ž  
+
+	unsigned long cutoff_index[WIDTH];	// cutoff_index[i] i° Ž  Ͼ beta cutoff Ƚ. solve() .
+
+	unsigned long column_nodes[WIDTH];	// root  column Ʒ Ž  
+
+	double column_ms[WIDTH];	// root  column Žϴ  ɸ ð(и)
+
+	int poll_nodes;     	// ð踦  ( ). ð踦     POLL_PERIOD_NS  Ѵ.
+
+	int poll_countdown; 	//  ð踦     
+
+	int64_t poll_last;  	//  thread  ð踦  ð. monotonic_ns() .
+
+	signed char killers[WIDTH * HEIGHT][2];	// killers[depth]  ̿ ֱٿ beta cutoff Ų  column, ٸ -1
+
+	unsigned int history[2][WIDTH][HEIGHT];	// history[player][column][row]   beta cutoff Ų 
+
+	int solve_column;   	//   solve()  column, ٸ -1. solve_outcome() solved cache Ѵ.
+
+	bool helper;        	// Lazy SMP   ʰ transposition table ä thread true
+
+	struct c4_ctx *ctx; 	//  Search_context  
+
+} Search_context;
 
 
 
 /**
-* @function c4_poll
-*
-* @param (*poll_func)(void) ų Լ
-* @param interval  Լ 
-*
-* interval  ù ° argument Լ Ѵ.
-* 츮 c4_poll(print_dot, CLOCKS_PER_SEC / 2)   Լ ߴµ,
-* ̰ 0.5  print_dot() ϶ ̴.
+* Root_job ü search_root() root Ž  thread    Ѵ.
+* C4_SMP_SPLIT  thread next  Ž  column ϳ ,
+* ݱ ּ (best_worst)  ٸ thread ã ε alpha-beta cutoff   ִ.
+* C4_SMP_LAZY search_contexts[0] column  ʰ Žϰ,  thread helperμ
+*  root ٸ ̿  Žϸ transposition table ä.
 */
 
-void
-c4_poll(void(*poll_func)(void), clock_t interval)
-{
-	poll_function = poll_func;
-	poll_interval = interval;
-}
+typedef struct {
+
+	const Game_state *root; 	// Ž    
+
+	int player, level;
+
+	int alpha, beta;        	// root  window. goodness beta ũ  column Ž ʴ´.
+
+	int columns[WIDTH];     	// Ž column. Ž  ȴ.
+
+	int num_columns;
+
+	int goodness[WIDTH];    	// columns[i]    goodness
+
+	int best_index;         	// ݱ   columns ε, ٸ -1. lock ȣѴ.
+
+	atomic_int next;        	//  Ž columns ε
+
+	atomic_int best_worst;  	// ݱ   goodness
+
+	bool lazy;              	// Lazy SMP ŽѴٸ true
+
+	mtx_t lock;
+
+} Root_job;
 
 
 
 /**
-* @function c4_new_game
-*
-* ο  ϱ ,
-*   ũ(6*7) ϱ  ؾ ϴ ӵ  (4) Ѵ.
-* ,   ӵ  ġ    迭 . 
-*  Լ ο  ϱ ؼ ʼ ҷ ϸ,
-*     ٽ θ  .
+* Tt_entry ü transposition table  ĭ , evaluate() ̹   ̴.
+* ٸ     鿡 ϸ ٽ Ž ʰ   Ѵ.
+* table Tt_slot  Ǿ ȴ.
 */
 
-void
-c4_new_game() //  !
-{
-	register int i, j, k, x;
-	int win_index, column;
-	int *win_indices;
+#define TT_EXACT 0  // score Ȯ 
+#define TT_LOWER 1  // beta cutoff Ͼ score Ѱ
+#define TT_UPPER 2  //   alpha  ؼ score Ѱ
 
-	assert(!game_in_progress); // ȣ  true pass, ̸  ޽ 
+#define TT_DEFAULT_MB 16
 
-	size_x = WIDTH;
-	size_y = HEIGHT;
-	total_size = WIDTH * HEIGHT;
-	num_to_connect = NUM_TO_CONNECT;
-	magic_win_number = 1 << num_to_connect; // magic_win_number = 16
-	win_places = num_of_win_places(size_x, size_y, num_to_connect); // win_places = 69. ̱  ִ   .
+#define SOLVER_DEFAULT_EMPTY 12
 
-	if (!seed_chosen) { //  score   random.
-		srand((unsigned int)time((time_t *)0));
-		seed_chosen = true;
-	}
+/*   ū score а  (INT_MAX - depth)̴. */
+/* order_moves() column ű  . history  HISTORY_MAX  ʰ Ѵ. */
+#define ORDER_WIN      (1u << 31)
+#define ORDER_BLOCK    (1u << 30)
+#define ORDER_TT       (1u << 29)
+#define ORDER_KILLER   (1u << 27)
+#define HISTORY_MAX    ((1u << 26) - 1)
 
-	/*  ϱ */
+/* aspiration_root()  Ž goodness  ó  window .   4 . */
+#define ASPIRATION_WINDOW 8
 
-	depth = 0;
-	current_state = &state_stack[0]; // initial state
+#define WIN_SCORE_BOUND (INT_MAX - WIDTH * HEIGHT - 1)
 
-	current_state->board = (char **)emalloc(size_x * sizeof(char *)); //  迭 board  (6x7) ϰ C4_NONE(=2) ä.
-	for (i = 0; i<size_x; i++) {
-		current_state->board[i] = (char *)emalloc(size_y);
-		for (j = 0; j<size_y; j++)
-			current_state->board[i][j] = C4_NONE;
-	}
+/* poll_search() 帶 ð踦  ʰ,  POLL_PERIOD_NS       . */
+#define POLL_PERIOD_NS 1000000
+#define POLL_MIN_NODES 16
+#define POLL_MAX_NODES 65536
 
-	/* score_array ϱ */
+typedef struct {
 
-	current_state->score_array[0] = (int *)emalloc(win_places * sizeof(int)); // 69  win_places  score  .
-	current_state->score_array[1] = (int *)emalloc(win_places * sizeof(int));
-	for (i = 0; i<win_places; i++) { // ϴ  1.
-		current_state->score_array[0][i] = 1;
-		current_state->score_array[1][i] = 1;
-	}
+	uint64_t key;       	//  hash  ʸ ģ . 0̸  ĭ.
 
-	current_state->score[0] = current_state->score[1] = win_places; // Player 0 1 ʱ  = 69.
-	current_state->winner = C4_NONE;  // winner  .
-	current_state->num_of_pieces = 0; // initial state̹Ƿ   0.
+	int score;          	//   player  score.  score  κ Ÿ .
 
-	states_allocated = 1;
+	signed char depth;  	//  score   Ž  
 
-	/* map ϱ */
+	unsigned char bound;	// TT_EXACT, TT_LOWER, TT_UPPER  ϳ
 
-	map = (int ***)emalloc(size_x * sizeof(int **)); // map 3 迭. 6x7x17 int   Ҵ. map[all][all][0] = -1 ʱȭ.
-	for (i = 0; i<size_x; i++) {
-		map[i] = (int **)emalloc(size_y * sizeof(int *));
-		for (j = 0; j<size_y; j++) {
-			map[i][j] = (int *)emalloc((num_to_connect * 4 + 1) * sizeof(int));
-			map[i][j][0] = -1;
-		}
-	}
+	signed char best_column;	//  鿡  Ҵ column, ٸ -1
 
-	win_index = 0;
+} Tt_entry;
 
-	/* Fill in the horizontal win positions */
-	for (i = 0; i<size_y; i++) // i = 0~6
-		for (j = 0; j<size_x - num_to_connect + 1; j++) { // j = 0~2
-			for (k = 0; k<num_to_connect; k++) { // k = 0~3
-				win_indices = map[j + k][i];
-				for (x = 0; win_indices[x] != -1; x++)
-					;
-				win_indices[x++] = win_index;
-				win_indices[x] = -1;
-			}
-			win_index++;
-		}
 
-	/* Fill in the vertical win positions */
-	for (i = 0; i<size_x; i++)
-		for (j = 0; j<size_y - num_to_connect + 1; j++) {
-			for (k = 0; k<num_to_connect; k++) {
-				win_indices = map[i][j + k];
-				for (x = 0; win_indices[x] != -1; x++)
-					;
-				win_indices[x++] = win_index;
-				win_indices[x] = -1;
-			}
-			win_index++;
-		}
 
-	/* Fill in the forward diagonal win positions */
-	for (i = 0; i<size_y - num_to_connect + 1; i++)
-		for (j = 0; j<size_x - num_to_connect + 1; j++) {
-			for (k = 0; k<num_to_connect; k++) {
-				win_indices = map[j + k][i + k];
-				for (x = 0; win_indices[x] != -1; x++)
-					;
-				win_indices[x++] = win_index;
-				win_indices[x] = -1;
-			}
-			win_index++;
-		}
+/**
+* Tt_slot ü transposition table  ĭ̴.  thread lock  Բ а .
+* key  Tt_entry data ϳ ϰ, check key ^ data Ѵ.
+*     ̿ ٸ thread   ٸ   ̸ check ^ data key  ʰ ǹǷ,
+* д   ĭ ٸ   .
+*/
 
-	/* Fill in the backward diagonal win positions */
-	for (i = 0; i<size_y - num_to_connect + 1; i++)
-		for (j = size_x - 1; j >= num_to_connect - 1; j--) {
-			for (k = 0; k<num_to_connect; k++) {
-				win_indices = map[j - k][i + k];
-				for (x = 0; win_indices[x] != -1; x++)
-					;
-				win_indices[x++] = win_index;
-				win_indices[x] = -1;
-			}
-			win_index++;
-		}
+typedef struct {
 
-	/* Set up the order in which automatic moves should be tried. */
-	/* The columns nearer to the center of the board are usually  */
-	/* better tactically and are more likely to lead to a win.	*/
-	/* By ordering the search such that the central columns are   */
-	/* tried first, alpha-beta cutoff is much more effective. 	*/
+	atomic_uint_least64_t check;	// key ^ data. data Բ 0̸  ĭ.
 
-	drop_order = (int *)emalloc(size_x * sizeof(int));
-	column = (size_x - 1) / 2;
-	for (i = 1; i <= size_x; i++) {
-		drop_order[i - 1] = column;
-		column += ((i % 2) ? i : -i);
-	}
+	atomic_uint_least64_t data; 	// score(32Ʈ), depth, bound, best_column( 8Ʈ)
 
-	game_in_progress = true;
-}
+} Tt_slot;
 
 
 
 /**
-* @function c4_make_move
-*
-* @param player     (0) Ǵ ǻ(1)
-* @param column    
-* @param row    
-* @return ǥ    ڸ false ϰ,
-*          Ҵٸ, true 
-*
-* parameter Էµ  ( Ǵ ) شϴ 
-* Էµ (row, column) ǥ ° ´
+* c4_ctx_open_solved_cache()  solved cache  Solved_header ڿ slots Tt_slot ̾ ̴.
+*  Ǯ    ϹǷ data score best_column,  ĭ ƴ Ÿ SOLVED_USED Ѵ.
+*  process   MAP_SHARED mmap()ؼ transposition table   lock  а .
+*  ߿ process ׾ check data  ϳ ٲ ĭ check ^ data key  Ƿ д  .
 */
 
-bool
-c4_make_move(int player, int column, int row)
-{
-	assert(game_in_progress);
-	assert(!move_in_progress);
+#define SOLVED_MAGIC "C4SOLVE\0"
+#define SOLVED_VERSION 1
+#define SOLVED_DEFAULT_MB 64
+#define SOLVED_PROBES 8     	//  key ãƺ ӵ ĭ (linear probing)
+#define SOLVED_USED ((uint64_t)1 << 63)
 
-	if (column >= size_x || column < 0 || row >= size_y || row < 0 || (current_state->board[column][row] != C4_NONE))
-		return false;
+/* ٸ process ϴ ޸𸮿 lock  atomic   . */
+#if HAVE_MMAP && ATOMIC_LLONG_LOCK_FREE == 2
+#define HAVE_SOLVED_CACHE 1
+#else
+#define HAVE_SOLVED_CACHE 0
+#endif
 
-	int result = drop_piece(real_player(player), column);
-	printf("\n * I dropped my piece on (%d, %d).\n", result + 1, column + 1);
-	return (result >= 0);
-}
+typedef struct {
+
+	char magic[8];      	// SOLVED_MAGIC
 
+	uint32_t version;   	// SOLVED_VERSION
+
+	uint16_t width, height;	//    ũ
+
+	uint64_t slots;     	// ڿ ̾ Tt_slot . ׻ 2 ŵ.
+
+	uint64_t reserved;
+
+} Solved_header;
 
 
 /**
-* @function c4_rule_auto_move
-*
-* @param player     (0) Ǵ ǻ(1)
-* @param column    ǥ ϱ  Ǵ 
-* @param row    ǥ ϱ  Ǵ 
-* @return   尡    ڸ ٸ false ,
-*          Ҵٸ, true 
-*
-* ǻͰ Heuristic̳ Rule ߿     ΰ  ,
-* Heuristic  õǾٸ Ǵ Լ̴.
-* parameter Էµ (player)  ǻͰ ŽƮ level ŭ ŽϿ  ⿡  ǥ ϰ,
-*  ڸ  ´.  column, row   ǥ Ѵ.
-*
-*   Բ ۼ ڵ,  ۼ Rule  Լ θ  ֵ ۼϿ.
+* struct c4_ctx   ϴ  ʿ  ¸ ´.
+* Ӹ ڽ c4_ctx Ƿ,  μ   ÿ   ִ.
+*  ٸ c4_ctx  ٸ thread ÿ ص ,  c4_ctx  thread ÿ ؼ  ȴ.
+* c4_ ϴ  Լ default_ctx Ѵ.
 */
 
-void c4_rule_auto_move(int player, int *column, int *row) {
+struct c4_ctx {
 
-	int check, min, i;
+	bool game_in_progress, move_in_progress;
 
-	check = rule1_1(player);
+	Search_context game_search;	//   . Ž  ¸  search_contexts Ѵ.
 
-	if (check != -1) {
-		printf(" * Rule 1 is used.\n");
-		*row = drop_piece(player, check);
-		*column = check;
-		return;
-	}
+	Game_state *current_state;	// &game_search.state
 
-	check = rule2_1(player);
+	char display_cells[WIDTH][HEIGHT];	// c4_ctx_board()   ä ǥÿ 
 
-	if (check != -1) {
-		printf(" * Rule 2 is used.\n");
-		*row = drop_piece(player, check);
-		*column = check;
-		return;
-	}
+	char *display_board[WIDTH];
 
-	int colArr[7];
+	void(*poll_function)(void);
 
-	rule6(player, colArr);
+	int64_t poll_interval, next_poll;	// poll_function θ (ns)  θ ð. ð monotonic_ns() .
 
-	for (i = 0; i < 7; i++) {
-		if (i == 0) min = colArr[i];
-		else if (colArr[i] < min) min = colArr[i];
-	}
+	int64_t search_deadline;	// c4_ctx_auto_move_timed() Ž  ϴ ð
 
-	check = rule3(player);
+	bool deadline_set;
 
-	if (check != -1) {
-		printf(" * Rule 3 is being checked.\n");
-		if (colArr[check] == min) {
-			printf(" * Rule 3 is used.\n");
-			*row = drop_piece(player, check);
-			*column = check;
-			return;
-		}
-		printf("* Rule 3 was rejected by Rule 6.\n");
-	}
+	atomic_bool search_aborted;
 
+	int solver_threshold;	//  ĭ   ϶  Ǯ 
 
-	check = rule4(player);
+	Tt_slot *tt_table;
 
-	if (check != -1) {
-		printf(" * Rule 4 is being checked.\n");
-		if (colArr[check] == min) {
-			printf(" * Rule 4 is used.\n");
-			*row = drop_piece(player, check);
-			*column = check;
-			return;
-		}
-		printf(" * Rule 4 was rejected by Rule 6.\n");
-	}
+	size_t tt_size;     	// tt_table ĭ . ׻ 2 ŵ̸, 0̸  .
 
+	bool tt_size_chosen;
 
-	check = rule5(player, colArr, min);
+	unsigned long tt_hits, tt_misses, tt_collisions;
 
-	if (check != -1) {
-		printf(" * Rule 5 & 6 were used.\n");
-		*row = drop_piece(player, check);
-		*column = check;
-		return;
-	}
-	else {
-		*row = defaultRule(player, column, colArr, min);
-		printf(" * Default rule & Rule 6 used.\n");
-	}
-	//printf("rule end\n");
-	return;
-}
+	unsigned long cutoffs, first_move_cutoffs;	// c4_new_game()  evaluate() beta cutoff 
 
+	int num_threads;
 
-/**
-* @function c4_auto_move
-*
-* @param player     (0) Ǵ ǻ(1)
-* @param level Ž Ʈ Ž  
-* @param column    ǥ ϱ  Ǵ 
-* @param row    ǥ ϱ  Ǵ 
-* @return   尡    ڸ ٸ false ,
-*          Ҵٸ, true 
-*
-* ǻͰ Heuristic̳ Rule ߿     ΰ  ,
-* Heuristic  õǾٸ Ǵ Լ̴.
-* parameter Էµ (player)  ǻͰ ŽƮ level ŭ ŽϿ  ⿡  ǥ ϰ,
-*  ڸ  ´.  column, row   ǥ Ѵ.
-*/
+	int smp_mode;
 
-bool
-c4_auto_move(int player, int level, int *column, int *row)
-{
-	int best_column = -1, goodness = 0, best_worst = -(INT_MAX);
-	int num_of_equal = 0, real_player, current_column, result, randNum;
-	int choice;
+	int search_mode;	// c4_ctx_auto_move() root Žϴ 
 
-	assert(game_in_progress);
-	assert(!move_in_progress);
-	assert(level >= 1 && level <= C4_MAX_LEVEL);
+	int engine;     	// c4_ctx_auto_move()   . C4_ENGINE_SEARCH Ǵ C4_ENGINE_RULE.
 
-	real_player = real_player(player);
+	c4_trace_func trace_function;	// Ž  rule Ǵ ˷  Լ. ٸ NULL.
 
-	printf(" (Heuristic : 1, Rule : 2)\n * Move choice : ");
-	scanf("%d", &choice);
-	printf("\n");
+	void *trace_data;	// trace_function ״ Ѱ 
 
-	if (choice == 2) {
-		c4_rule_auto_move(player, column, row);
-		return true;
-	}
+	int last_goodness[2];	//  player    goodness. MTD(f) ù  .
 
-	if (current_state->num_of_pieces < 2) {
-		if (current_state->num_of_pieces == 0) {
-			randNum = rand() % 2;
-			if (randNum == 0) {
-				if (column != NULL) {
-					*column = 2;
-				}
-				if (row != NULL) *row = 0;
-				*row = drop_piece(real_player, 2);
-			}
-			else {
-				if (column != NULL) {
-					*column = 4;
-				}
-				if (row != NULL) *row = 0;
-				*row = drop_piece(real_player, 4);
-			}
-		}
-		else {
-			if (column != NULL) {
-				*column = 3;
-			}
-			if (row != NULL)
-				*row = current_state->num_of_pieces;
-			*row = drop_piece(real_player, 3);
-		}
-		return true;
-	}
+	void *book_map;     	// c4_ctx_load_book()  opening book  ü. ٸ NULL.
 
-	move_in_progress = true;
+	size_t book_map_size;
 
-	/* Simulate a drop in each of the columns and see what the results are. */
+	bool book_mapped;   	// book_map mmap() ٸ true, ޸𸮿 о 鿴ٸ false
 
-	int Hdrop_order[7];
-	heuristicDropOrder(real_player, Hdrop_order);    //Į      Į  Ŀ minmax Ž   Ѵ.
-	for (int i = 0; i<size_x; i++) {
-		push_state();
-		current_column = Hdrop_order[i];
+	const c4_book_entry *book;	// book_map  entry 迭. key  ĵǾ ִ.
 
-		result = drop_piece(real_player, current_column);
+	size_t book_entries;
 
-		/* If this column is full, ignore it as a possibility. */
-		if (result < 0) {
-			pop_state();
-			continue;
+	void *solved_map;   	// c4_ctx_open_solved_cache()  solved cache  ü. ٸ NULL.
+
+	size_t solved_map_size;
+
+	Tt_slot *solved_table;	// solved_map  ĭ 迭
+
+	size_t solved_size; 	// solved_table ĭ . ׻ 2 ŵ̸, 0̸  .
+
+	atomic_bool helpers_stop;	// Lazy SMP search_contexts[0] Ž  helper  Ѵٸ true
+
+	Search_context *search_contexts;	// search_contexts[0] c4_ctx_auto_move() θ thread,  workers 
+
+	thrd_t *workers;
+
+	bool pool_ready;
+
+	mtx_t pool_lock;
+
+	cnd_t pool_wake, pool_done;
+
+	int pool_generation, pool_busy;	//  Root_job pool_generation þ, pool_busy  Ž  worker 
+
+	bool pool_quit;
+
+	Root_job *pool_job;
+
+};
+
+
+
+/**
+* Static global variables
+*
+* Ʒ    Բ ϸ, ó  ڷδ ٲ ʴ´.
+*/
+
+static const int size_x = WIDTH, size_y = HEIGHT, total_size = WIDTH * HEIGHT;
+static const int num_to_connect = NUM_TO_CONNECT;
+static const int win_places = WIN_PLACES;  // ̱  ִ   . 7*6 忡 69.
+static const int magic_win_number = 1 << NUM_TO_CONNECT;  // 16
+
+static bool seed_chosen = false;
+static c4_ctx *default_ctx = NULL;  // c4_ ϴ  Լ ϴ c4_ctx
+
+static uint64_t zobrist[2][WIDTH * (HEIGHT + 1)];  // zobrist[player][Ʈ ȣ]
+static uint64_t zobrist_turn;                      // player 1    key XORϴ 
+
+#define CACHE_LINE 64
+
+/* Ʒ ǥ init_tables() ó   ,  ڷδ   б⸸ Ѵ. */
+
+/*
+* map  ĭ  win place ε CSR(compressed sparse row)  Ѵ.
+* (x, y) ĭ win place map_lines[map_begin(x, y)] map_lines[map_end(x, y) - 1] ̾ Ǿ ִ.
+*/
+
+#define map_cell(x, y)  ((x) * HEIGHT + (y))
+#define map_begin(x, y) (map_offsets[map_cell(x, y)])
+#define map_end(x, y)   (map_offsets[map_cell(x, y) + 1])
+
+#if WIN_PLACES > 256
+#error "map_lines win place ε uint8_t Ѵ."
+#endif
+
+static _Alignas(CACHE_LINE) uint16_t map_offsets[WIDTH * HEIGHT + 1];
+static _Alignas(CACHE_LINE) uint8_t map_lines[WIN_PLACES * NUM_TO_CONNECT];
+static _Alignas(CACHE_LINE) signed char win_lines[WIN_PLACES][NUM_TO_CONNECT][2];	// win_lines[w][k] w° win place k° ĭ (x, y)
+static int drop_order[WIDTH];
+static void (*score_mask)(const int8_t *scores, int value, uint32_t *mask);	// init_tables() CPU ´ Ŀ .
+static once_flag tables_once = ONCE_FLAG_INIT;
+
+
+
+/**
+* A declaration of the local functions.
+*/
+
+static int num_of_win_places(int x, int y, int n);
+static int popcount64(uint64_t bits);
+static bool has_alignment(uint64_t bits);
+static void score_mask_scalar(const int8_t *scores, int value, uint32_t *mask);
+#ifdef HAVE_X86_SIMD
+static void score_mask_sse2(const int8_t *scores, int value, uint32_t *mask);
+static void score_mask_avx2(const int8_t *scores, int value, uint32_t *mask);
+#endif
+static bool has_line(const uint32_t *mask, int win_index);
+static int next_line(const uint32_t *mask, int from);
+static int board_cell(const c4_ctx *ctx, int x, int y);
+static int column_height(const Game_state *state, int column);
+static void update_score(Game_state *state, int player, int x, int y, Undo_record *undo);
+static int drop_piece(Search_context *sc, int player, int column);
+static void undo_piece(Search_context *sc);
+static void init_tables(void);
+static void init_zobrist(void);
+static bool is_symmetric(const Game_state *state);
+static uint64_t position_key(const Game_state *state, int player, bool *mirrored);
+static bool tt_probe(Search_context *sc, uint64_t key, Tt_entry *found);
+static int tt_score(const Search_context *sc, const Tt_entry *entry);
+static void tt_store(const Search_context *sc, uint64_t key, int remaining, int score, int alpha, int beta, int best_column);
+static bool opening_move(c4_ctx *ctx, int player, int *column, int *row);
+static bool rule_move(c4_ctx *ctx, int player, int *column, int *row);
+static bool book_move(c4_ctx *ctx, int player, int *column);
+static void unload_book(c4_ctx *ctx);
+#if HAVE_SOLVED_CACHE
+static int create_solved_cache(const char *path, int megabytes);
+#endif
+static void close_solved_cache(c4_ctx *ctx);
+static bool solved_probe(Search_context *sc, int player, int *score);
+static void solved_store(const Search_context *sc, int player, int score, int best_column);
+static int search_level(c4_ctx *ctx, int player, int level, bool report, int *best_goodness);
+static int search_timed(c4_ctx *ctx, int player, int budget_ms, int *best_goodness, int *depth);
+static int search_root(c4_ctx *ctx, int player, int level, int first_column, bool report, int alpha, int beta, int *best_goodness);
+static int mtdf_root(c4_ctx *ctx, int player, int level, bool report, int *best_goodness);
+static int aspiration_root(c4_ctx *ctx, int player, int level, bool report, int *best_goodness);
+static void run_root_job(Search_context *sc, Root_job *job);
+static void run_lazy_helper(Search_context *sc, Root_job *job);
+static void stop_workers(c4_ctx *ctx);
+static int worker_main(void *arg);
+static void reset_node_counts(c4_ctx *ctx);
+static void count_root_column(Search_context *sc, int column, unsigned long nodes, const struct timespec *start);
+static void reset_move_ordering(c4_ctx *ctx);
+static int order_moves(const Search_context *sc, int player, int first_column, int *order);
+static void record_cutoff(Search_context *sc, int player, int column, int row, int remaining);
+static bool search_stopped(const Search_context *sc);
+static bool poll_search(Search_context *sc);
+static bool poll_clock(Search_context *sc);
+static void reset_poll(c4_ctx *ctx);
+static int64_t monotonic_ns(void);
+static int evaluate(Search_context *sc, int player, int level, int alpha, int beta);
+static int solve_outcome(Search_context *sc, int player);
+static int solve(Search_context *sc, int player, int alpha, int beta);
+static void heuristic_drop_order(const Game_state *state, int player, int *dropOrder);
+static void trace_event(const c4_ctx *ctx, c4_trace_event *event);
+static void trace_rule(const c4_ctx *ctx, int rule, int verdict);
+static c4_ctx *default_context(void);
+static void *emalloc(size_t size);
+
+
+
+/**
+* @function c4_ctx_new
+*
+* @return   c4_ctx
+*
+*  ϳ  c4_ctx .   ⺻̸, c4_ctx_new_game()    ִ.
+* Ӹ c4_ctx    μ   ÿ   ִ.
+*/
+
+c4_ctx *
+c4_ctx_new(void)
+{
+	c4_ctx *ctx = (c4_ctx *)emalloc(sizeof(c4_ctx));
+
+	memset(ctx, 0, sizeof(c4_ctx));
+	ctx->game_search.ctx = ctx;
+	ctx->current_state = &ctx->game_search.state;
+	ctx->solver_threshold = SOLVER_DEFAULT_EMPTY;
+	ctx->num_threads = 1;
+	ctx->smp_mode = C4_SMP_LAZY;
+	ctx->search_mode = C4_SEARCH_ASPIRATION;
+	ctx->engine = C4_ENGINE_SEARCH;
+	atomic_init(&ctx->search_aborted, false);
+	atomic_init(&ctx->helpers_stop, false);
+	return ctx;
+}
+
+
+
+/**
+* @function c4_ctx_free
+*
+* @param ctx  c4_ctx
+*
+*    ִٸ , ctx thread transposition table   ޸𸮸 .
+*/
+
+void
+c4_ctx_free(c4_ctx *ctx)
+{
+	assert(!ctx->move_in_progress);
+
+	if (ctx->game_in_progress)
+		c4_ctx_end_game(ctx);
+
+	stop_workers(ctx);
+	if (ctx->pool_ready) {
+		mtx_destroy(&ctx->pool_lock);
+		cnd_destroy(&ctx->pool_wake);
+		cnd_destroy(&ctx->pool_done);
+	}
+	free(ctx->search_contexts);
+	free(ctx->tt_table);
+	unload_book(ctx);
+	close_solved_cache(ctx);
+	free(ctx);
+}
+
+
+
+/**
+* @function c4_ctx_poll
+*
+* @param ctx  c4_ctx
+* @param (*poll_func)(void) ų Լ
+* @param interval  Լ 
+*
+* interval  ù ° argument Լ Ѵ.
+* 츮 c4_poll(print_dot, CLOCKS_PER_SEC / 2)   Լ ߴµ,
+* ̰ 0.5  print_dot() ϶ ̴.
+* interval clock()  ,  process CPU ð ƴ  帥 ð(monotonic clock) .
+*/
+
+void
+c4_ctx_poll(c4_ctx *ctx, void(*poll_func)(void), clock_t interval)
+{
+	ctx->poll_function = poll_func;
+	ctx->poll_interval = (int64_t)((double)interval * 1e9 / CLOCKS_PER_SEC);
+}
+
+
+
+/**
+* @function c4_ctx_set_hash_size
+*
+* @param ctx  c4_ctx
+* @param megabytes transposition table  ޸ ũ(MB). 0̸ transposition table  ʴ´.
+*
+* megabytes  ʴ  ū 2 ŵ  ĭ transposition table  .
+* Ǿ ִ  hit/miss/collision Ƚ  .
+* θ  ó c4_new_game() θ  16MB .
+*/
+
+void
+c4_ctx_set_hash_size(c4_ctx *ctx, int megabytes)
+{
+	size_t bytes, entries;
+
+	assert(!ctx->move_in_progress);
+	assert(megabytes >= 0);
+
+	free(ctx->tt_table);
+	ctx->tt_table = NULL;
+	ctx->tt_size = 0;
+	ctx->tt_hits = ctx->tt_misses = ctx->tt_collisions = 0;
+	ctx->tt_size_chosen = true;
+
+	bytes = (size_t)megabytes * 1024 * 1024;
+	for (entries = 1; entries * 2 * sizeof(Tt_slot) <= bytes; entries *= 2)
+		;
+	if (entries * sizeof(Tt_slot) > bytes)
+		return;
+
+	ctx->tt_table = (Tt_slot *)emalloc(entries * sizeof(Tt_slot));
+	memset(ctx->tt_table, 0, entries * sizeof(Tt_slot));
+	ctx->tt_size = entries;
+}
+
+
+
+/**
+* @function c4_ctx_hash_stats
+*
+* @param ctx  c4_ctx
+* @param hits   ã Ƚ  
+* @param misses ã ĭ  ־ Ƚ  
+* @param collisions ã ĭ ٸ  Ǿ ־ Ƚ  
+*
+*  c4_set_hash_size() θ  transposition table  踦 ˷ش.
+* collisions hits  ٸ table ũ⸦ ø  . NULL ʹ Ѵ.
+*/
+
+void
+c4_ctx_hash_stats(c4_ctx *ctx, unsigned long *hits, unsigned long *misses, unsigned long *collisions)
+{
+	if (hits != NULL)
+		*hits = ctx->tt_hits;
+	if (misses != NULL)
+		*misses = ctx->tt_misses;
+	if (collisions != NULL)
+		*collisions = ctx->tt_collisions;
+}
+
+
+
+/**
+* @function c4_ctx_cutoff_stats
+*
+* @param ctx  c4_ctx
+* @param cutoffs evaluate() beta cutoff Ͼ Ƚ  
+* @param first_move_cutoffs  ó Ž  ٷ cutoff Ͼ Ƚ  
+*
+*  c4_new_game() θ  move ordering 踦 ˷ش.
+* first_move_cutoffs / cutoffs 1      Žϰ ִٴ ̴. NULL ʹ Ѵ.
+*/
+
+void
+c4_ctx_cutoff_stats(c4_ctx *ctx, unsigned long *cutoffs, unsigned long *first_move_cutoffs)
+{
+	if (cutoffs != NULL)
+		*cutoffs = ctx->cutoffs;
+	if (first_move_cutoffs != NULL)
+		*first_move_cutoffs = ctx->first_move_cutoffs;
+}
+
+
+
+/**
+* @function c4_ctx_get_search_stats
+*
+* @param ctx  c4_ctx
+* @param stats 踦  c4_search_stats
+*
+*  ǻͰ  鼭(c4_auto_move(), c4_search() ) Ž   thread   ˷ش.
+*   rootκ ̺ , beta cutoff  °  Ͼ root column    ð .
+*   thread  ΰ ⼭ ϹǷ Ž   ʴ´.
+* aspiration search MTD(f)ó root   Žߴٸ   ̴.  thread column_ms  thread ð  ̴.
+*/
+
+void
+c4_ctx_get_search_stats(c4_ctx *ctx, c4_search_stats *stats)
+{
+	const Search_context *sc;
+	int i, j;
+
+	memset(stats, 0, sizeof(c4_search_stats));
+	if (ctx->search_contexts == NULL)
+		return;
+
+	for (i = 0; i < ctx->num_threads; i++) {
+		sc = &ctx->search_contexts[i];
+		stats->nodes += sc->nodes;
+		stats->interior_nodes += sc->interior_nodes;
+		for (j = 0; j <= WIDTH * HEIGHT; j++) {
+			stats->ply_nodes[j] += sc->ply_nodes[j];
+			if (sc->ply_nodes[j] > 0 && j > stats->max_depth)
+				stats->max_depth = j;
+		}
+		for (j = 0; j < WIDTH; j++) {
+			stats->cutoff_index[j] += sc->cutoff_index[j];
+			stats->cutoffs += sc->cutoff_index[j];
+			stats->column_nodes[j] += sc->column_nodes[j];
+			stats->column_ms[j] += sc->column_ms[j];
+		}
+	}
+	stats->leaf_nodes = stats->nodes - stats->interior_nodes;
+}
+
+
+
+/**
+* @function c4_ctx_set_solver_threshold
+*
+* @param ctx  c4_ctx
+* @param empty_cells     ĭ  heuristic    ŽѴ. 0̸  ʴ´.
+*
+*  Ĺݿ  Ž Ʈ Ƿ, level ߰ goodness ϴ 
+* //и ϴ solver ٲ۴.   level  ȮϹǷ  ϰ ΰ,
+*  κ Ʈ  Ž ʾƵ ȴ. ⺻ 12̴.
+*/
+
+void
+c4_ctx_set_solver_threshold(c4_ctx *ctx, int empty_cells)
+{
+	assert(!ctx->move_in_progress);
+	assert(empty_cells >= 0);
+
+	ctx->solver_threshold = empty_cells;
+}
+
+
+
+/**
+* @function c4_ctx_set_threads
+*
+* @param ctx  c4_ctx
+* @param threads ǻͰ    Բ Ž thread . 1 C4_MAX_THREADS.
+*
+* threads 2 ̸̻ c4_set_smp_mode()    thread ÿ ŽѴ.
+*  thread ڽ Search_context ϰ transposition table lock  Բ Ѵ.
+* ̹  thread   . θ  thread ϳ ŽѴ.
+*/
+
+void
+c4_ctx_set_threads(c4_ctx *ctx, int threads)
+{
+	int i;
+
+	assert(!ctx->move_in_progress);
+	assert(threads >= 1 && threads <= C4_MAX_THREADS);
+
+	if (!ctx->pool_ready) {
+		mtx_init(&ctx->pool_lock, mtx_plain);
+		cnd_init(&ctx->pool_wake);
+		cnd_init(&ctx->pool_done);
+		ctx->pool_ready = true;
+	}
+
+	stop_workers(ctx);
+
+	free(ctx->search_contexts);
+	ctx->search_contexts = (Search_context *)emalloc(threads * sizeof(Search_context));
+	memset(ctx->search_contexts, 0, threads * sizeof(Search_context));
+	for (i = 0; i<threads; i++) {
+		ctx->search_contexts[i].ctx = ctx;
+		ctx->search_contexts[i].poll_nodes = POLL_MIN_NODES;
+	}
+	ctx->num_threads = threads;
+	ctx->pool_quit = false;
+	ctx->pool_generation = 0;
+
+	if (threads > 1) {
+		ctx->workers = (thrd_t *)emalloc((threads - 1) * sizeof(thrd_t));
+		for (i = 1; i<threads; i++)
+			if (thrd_create(&ctx->workers[i - 1], worker_main, &ctx->search_contexts[i]) != thrd_success) {
+				c4_trace_event event = { .kind = C4_TRACE_ERROR };
+
+				/* ̹  thread鸸 Ѵ. */
+				ctx->num_threads = i;
+				event.thread = i;
+				event.message = "c4_ctx_set_threads() - Can't create thread.";
+				trace_event(ctx, &event);
+				break;
+			}
+	}
+}
+
+
+
+/**
+* @function c4_ctx_set_smp_mode
+*
+* @param ctx  c4_ctx
+* @param mode C4_SMP_LAZY Ǵ C4_SMP_SPLIT
+*
+* thread   ̻  Ž   Ѵ.
+* C4_SMP_SPLIT root column thread  ŽѴ.  column κ Ʈ κ ϴ ߹ݿ
+*  column  thread ϳ ϰ Ǿ  ʴ´.
+* C4_SMP_LAZY(⺻)  thread  root Žϵ, helper thread ̿ column  ݾ ٲپ Žϸ
+* transposition table ä.  ȣ thread  Ƿ, helper   п  Ž  .
+*/
+
+void
+c4_ctx_set_smp_mode(c4_ctx *ctx, int mode)
+{
+	assert(!ctx->move_in_progress);
+	assert(mode == C4_SMP_LAZY || mode == C4_SMP_SPLIT);
+
+	ctx->smp_mode = mode;
+}
+
+
+
+/**
+* @function c4_ctx_set_search_mode
+*
+* @param ctx  c4_ctx
+* @param mode C4_SEARCH_ASPIRATION, C4_SEARCH_ALPHABETA Ǵ C4_SEARCH_MTDF
+*
+* c4_auto_move() root Žϴ  Ѵ.
+* C4_SEARCH_ASPIRATION(⺻)     Ž ,  goodness ߽  window   ŽѴ.
+*  window   window  ٽ ŽѴ.
+* C4_SEARCH_ALPHABETA  column    window ŽѴ.
+* C4_SEARCH_MTDF  player    goodness ,  0 window root Ǯ Žϸ
+* goodness  .   Ž ξ ,      Žؾ Ѵ.
+*     goodness .
+*/
+
+void
+c4_ctx_set_search_mode(c4_ctx *ctx, int mode)
+{
+	assert(!ctx->move_in_progress);
+	assert(mode == C4_SEARCH_ALPHABETA || mode == C4_SEARCH_MTDF || mode == C4_SEARCH_ASPIRATION);
+
+	ctx->search_mode = mode;
+}
+
+
+
+/**
+* @function c4_ctx_set_engine
+*
+* @param ctx  c4_ctx
+* @param engine C4_ENGINE_SEARCH Ǵ C4_ENGINE_RULE
+*
+* c4_auto_move() c4_auto_move_timed()    Ѵ.
+* C4_ENGINE_SEARCH(⺻) Ž Ʈ Žϰ, C4_ENGINE_RULE c4_rule_auto_move() rule .
+*/
+
+void
+c4_ctx_set_engine(c4_ctx *ctx, int engine)
+{
+	assert(!ctx->move_in_progress);
+	assert(engine == C4_ENGINE_SEARCH || engine == C4_ENGINE_RULE);
+
+	ctx->engine = engine;
+}
+
+
+
+/**
+* @function c4_ctx_set_trace
+*
+* @param ctx  c4_ctx
+* @param trace_func Ž  rule Ǵ c4_trace_event  Լ. NULL̸ ˸ ʴ´.
+* @param data trace_func ״ Ѱ 
+*
+* engine ƹ͵  ʴ´. ȭ̳ log     Լ ޾Ƽ front-end Ѵ.
+* trace_func c4_auto_move() θ thread Ҹ.
+*/
+
+void
+c4_ctx_set_trace(c4_ctx *ctx, c4_trace_func trace_func, void *data)
+{
+	assert(!ctx->move_in_progress);
+
+	ctx->trace_function = trace_func;
+	ctx->trace_data = data;
+}
+
+
+
+/**
+* @function c4_ctx_load_book
+*
+* @param ctx  c4_ctx
+* @param path opening book  . NULL̸  ִ book ݱ⸸ Ѵ.
+* @return book ٸ true,  ų   ũ book ƴ϶ false
+*
+* book  α׷(book.c)   б  mmap()ؼ,  engine process  page Բ .
+* book   c4_auto_move() c4_auto_move_timed() Žϱ    book ã,
+* ִٸ  column ٷ  ´. book   machine byte order ƾ Ѵ.
+*/
+
+bool
+c4_ctx_load_book(c4_ctx *ctx, const char *path)
+{
+	const c4_book_header *header;
+
+	assert(!ctx->move_in_progress);
+
+	unload_book(ctx);
+	if (path == NULL)
+		return true;
+
+#if HAVE_MMAP
+	{
+		struct stat st;
+		int fd = open(path, O_RDONLY);
+
+		if (fd < 0)
+			return false;
+		if (fstat(fd, &st) < 0 || st.st_size < (off_t)sizeof(c4_book_header)) {
+			close(fd);
+			return false;
+		}
+		ctx->book_map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		close(fd);
+		if (ctx->book_map == MAP_FAILED) {
+			ctx->book_map = NULL;
+			return false;
+		}
+		ctx->book_map_size = (size_t)st.st_size;
+		ctx->book_mapped = true;
+	}
+#else
+	{
+		FILE *file = fopen(path, "rb");
+		long size;
+
+		if (file == NULL)
+			return false;
+		if (fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) < (long)sizeof(c4_book_header)) {
+			fclose(file);
+			return false;
+		}
+		rewind(file);
+		ctx->book_map = emalloc((size_t)size);
+		ctx->book_map_size = (size_t)size;
+		ctx->book_mapped = false;
+		if (fread(ctx->book_map, 1, (size_t)size, file) != (size_t)size) {
+			fclose(file);
+			unload_book(ctx);
+			return false;
+		}
+		fclose(file);
+	}
+#endif
+
+	header = (const c4_book_header *)ctx->book_map;
+	if (memcmp(header->magic, C4_BOOK_MAGIC, sizeof(header->magic)) != 0 ||
+		header->version != C4_BOOK_VERSION ||
+		header->width != WIDTH || header->height != HEIGHT ||
+		header->count != (ctx->book_map_size - sizeof(c4_book_header)) / sizeof(c4_book_entry) ||
+		(ctx->book_map_size - sizeof(c4_book_header)) % sizeof(c4_book_entry) != 0) {
+		unload_book(ctx);
+		return false;
+	}
+
+	ctx->book = (const c4_book_entry *)(header + 1);
+	ctx->book_entries = (size_t)header->count;
+	return true;
+}
+
+
+
+/**
+* @function c4_ctx_open_solved_cache
+*
+* @param ctx  c4_ctx
+* @param path solved cache  . NULL̸  ִ cache ݱ⸸ Ѵ.
+* @param megabytes      ũ. 0̸ SOLVED_DEFAULT_MB. ̹ ִ   ũ .
+* @return cache ٸ true,    ų   ũ cache ƴ϶ false
+*
+*  Ǯ   (//п ׶ best column) process   Ͽ Ѵ.
+* evaluate() solver θ  cache ãƺ, solve_outcome()    cache .
+*  machine  engine process   Բ      ִ.
+*  ӽ Ͽ header    link() ̸ ̹Ƿ, ٸ process     ʴ´.
+* mmap()   ׻ false Ѵ.
+*/
+
+bool
+c4_ctx_open_solved_cache(c4_ctx *ctx, const char *path, int megabytes)
+{
+	assert(!ctx->move_in_progress);
+	assert(megabytes >= 0);
+
+	close_solved_cache(ctx);
+	if (path == NULL)
+		return true;
+
+#if HAVE_SOLVED_CACHE
+	{
+		const Solved_header *header;
+		struct stat st;
+		int fd = open(path, O_RDWR);
+
+		if (fd < 0 && errno == ENOENT)
+			fd = create_solved_cache(path, megabytes);
+		if (fd < 0)
+			return false;
+		if (fstat(fd, &st) < 0 || st.st_size < (off_t)sizeof(Solved_header)) {
+			close(fd);
+			return false;
+		}
+		ctx->solved_map = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		close(fd);
+		if (ctx->solved_map == MAP_FAILED) {
+			ctx->solved_map = NULL;
+			return false;
+		}
+		ctx->solved_map_size = (size_t)st.st_size;
+
+		header = (const Solved_header *)ctx->solved_map;
+		if (memcmp(header->magic, SOLVED_MAGIC, sizeof(header->magic)) != 0 ||
+			header->version != SOLVED_VERSION ||
+			header->width != WIDTH || header->height != HEIGHT ||
+			header->slots == 0 || (header->slots & (header->slots - 1)) != 0 ||
+			header->slots != (ctx->solved_map_size - sizeof(Solved_header)) / sizeof(Tt_slot) ||
+			(ctx->solved_map_size - sizeof(Solved_header)) % sizeof(Tt_slot) != 0) {
+			close_solved_cache(ctx);
+			return false;
+		}
+
+		ctx->solved_table = (Tt_slot *)(header + 1);
+		ctx->solved_size = (size_t)header->slots;
+		return true;
+	}
+#else
+	return false;
+#endif
+}
+
+
+
+/**
+* @function c4_ctx_thread_nodes
+*
+* @param ctx  c4_ctx
+* @param thread 0 c4_set_threads()   - 1. 0 c4_auto_move() θ thread̴.
+* @return  ǻͰ     thread Ž  
+*
+* thread  ٲپ   鿡 ϸ,   ɸ ð  Ž 󸶳    ִ.
+*/
+
+unsigned long
+c4_ctx_thread_nodes(c4_ctx *ctx, int thread)
+{
+	assert(thread >= 0 && thread < ctx->num_threads);
+
+	return ctx->search_contexts[thread].nodes;
+}
+
+
+
+/**
+* @function c4_ctx_new_game
+*
+* @param ctx  c4_ctx
+*
+* ο  ϱ ,
+*   ũ(6*7) ϱ  ؾ ϴ ӵ  (4) Ѵ.
+* ,   ӵ  ġ    迭 . 
+*  Լ ο  ϱ ؼ ʼ ҷ ϸ,
+*     ٽ θ  .
+*/
+
+void
+c4_ctx_new_game(c4_ctx *ctx) //  !
+{
+	register int i;
+
+	assert(!ctx->game_in_progress); // ȣ  true pass, ̸  ޽ 
+
+	if (!seed_chosen) { //  score   random.
+		srand((unsigned int)time((time_t *)0));
+		seed_chosen = true;
+	}
+
+	call_once(&tables_once, init_tables);
+	if (!ctx->tt_size_chosen)
+		c4_ctx_set_hash_size(ctx, TT_DEFAULT_MB);
+	if (ctx->search_contexts == NULL)
+		c4_ctx_set_threads(ctx, 1);
+
+	/*  ϱ */
+
+	ctx->game_search.depth = 0;
+	ctx->current_state = &ctx->game_search.state; // initial state
+
+	ctx->current_state->position = 0; //    Ʈ  0.
+	ctx->current_state->mask = 0;
+
+	/* score_array ʱȭϱ */
+
+	assert(num_of_win_places(size_x, size_y, num_to_connect) == win_places); // 69  win_places  score  .
+	memset(ctx->current_state->score_array, 0, sizeof(ctx->current_state->score_array)); // þ ĭ 0.
+	for (i = 0; i<win_places; i++) { // ϴ  1.
+		ctx->current_state->score_array[0][i] = 1;
+		ctx->current_state->score_array[1][i] = 1;
+	}
+
+	ctx->current_state->score[0] = ctx->current_state->score[1] = win_places; // Player 0 1 ʱ  = 69.
+	ctx->current_state->winner = C4_NONE;  // winner  .
+	ctx->current_state->num_of_pieces = 0; // initial state̹Ƿ   0.
+	ctx->current_state->hash = ctx->current_state->hash_mirror = 0;
+
+	ctx->cutoffs = ctx->first_move_cutoffs = 0;
+	ctx->last_goodness[0] = ctx->last_goodness[1] = 0;
+
+	ctx->game_in_progress = true;
+}
+
+
+
+/**
+* @function c4_ctx_make_move
+*
+* @param ctx  c4_ctx
+* @param player     (0) Ǵ ǻ(1)
+* @param column    
+* @param row    
+* @return ǥ    ڸ false ϰ,
+*          Ҵٸ, true 
+*
+* parameter Էµ  ( Ǵ ) شϴ 
+* Էµ (row, column) ǥ ° ´
+*/
+
+bool
+c4_ctx_make_move(c4_ctx *ctx, int player, int column, int row)
+{
+	assert(ctx->game_in_progress);
+	assert(!ctx->move_in_progress);
+
+	if (column >= size_x || column < 0 || row >= size_y || row < 0 || (board_cell(ctx, column, row) != C4_NONE))
+		return false;
+
+	return (drop_piece(&ctx->game_search, real_player(player), column) >= 0);
+}
+
+
+
+/**
+* @function c4_ctx_rule_auto_move
+*
+* @param ctx  c4_ctx
+* @param player     (0) Ǵ ǻ(1)
+* @param column    ǥ ϱ  Ǵ 
+* @param row    ǥ ϱ  Ǵ 
+* @return   尡    ڸ ٸ false ,
+*          Ҵٸ, true 
+*
+* ǻͰ Heuristic̳ Rule ߿     ΰ  ,
+* Heuristic  õǾٸ Ǵ Լ̴.
+* parameter Էµ (player)  ǻͰ ŽƮ level ŭ ŽϿ  ⿡  ǥ ϰ,
+*  ڸ  ´.  column, row   ǥ Ѵ.
+*
+*   Բ ۼ ڵ,  ۼ Rule  Լ θ  ֵ ۼϿ.
+*/
+
+void c4_ctx_rule_auto_move(c4_ctx *ctx, int player, int *column, int *row) {
+
+	int check, min, i;
+
+	check = rule1_1(ctx, player);
+
+	if (check != -1) {
+		trace_rule(ctx, 1, C4_RULE_USED);
+		*row = drop_piece(&ctx->game_search, player, check);
+		*column = check;
+		return;
+	}
+
+	check = rule2_1(ctx, player);
+
+	if (check != -1) {
+		trace_rule(ctx, 2, C4_RULE_USED);
+		*row = drop_piece(&ctx->game_search, player, check);
+		*column = check;
+		return;
+	}
+
+	int colArr[7];
+
+	rule6(ctx, player, colArr);
+
+	for (i = 0; i < 7; i++) {
+		if (i == 0) min = colArr[i];
+		else if (colArr[i] < min) min = colArr[i];
+	}
+
+	check = rule3(ctx, player);
+
+	if (check != -1) {
+		trace_rule(ctx, 3, C4_RULE_CHECKED);
+		if (colArr[check] == min) {
+			trace_rule(ctx, 3, C4_RULE_USED);
+			*row = drop_piece(&ctx->game_search, player, check);
+			*column = check;
+			return;
+		}
+		trace_rule(ctx, 3, C4_RULE_REJECTED);
+	}
+
+
+	check = rule4(ctx, player);
+
+	if (check != -1) {
+		trace_rule(ctx, 4, C4_RULE_CHECKED);
+		if (colArr[check] == min) {
+			trace_rule(ctx, 4, C4_RULE_USED);
+			*row = drop_piece(&ctx->game_search, player, check);
+			*column = check;
+			return;
+		}
+		trace_rule(ctx, 4, C4_RULE_REJECTED);
+	}
+
+
+	check = rule5(ctx, player, colArr, min);
+
+	if (check != -1) {
+		trace_rule(ctx, 5, C4_RULE_USED);
+		*row = drop_piece(&ctx->game_search, player, check);
+		*column = check;
+		return;
+	}
+	else {
+		*row = defaultRule(ctx, player, column, colArr, min);
+		trace_rule(ctx, 0, C4_RULE_USED);
+	}
+	//printf("rule end\n");
+	return;
+}
+
+
+/**
+* @function c4_ctx_auto_move
+*
+* @param ctx  c4_ctx
+* @param player     (0) Ǵ ǻ(1)
+* @param level Ž Ʈ Ž  
+* @param column    ǥ ϱ  Ǵ 
+* @param row    ǥ ϱ  Ǵ 
+* @return   尡    ڸ ٸ false ,
+*          Ҵٸ, true 
+*
+* parameter Էµ (player)  ǻͰ ŽƮ level ŭ ŽϿ  ⿡  ǥ ϰ,
+*  ڸ  ´.  column, row   ǥ Ѵ.
+* c4_set_engine() C4_ENGINE_RULE ٸ Ž ʰ c4_rule_auto_move() ´.
+* root Ž  c4_set_search_mode() Ѵ. c4_load_book()  book   ִٸ Ž ʴ´.
+*/
+
+bool
+c4_ctx_auto_move(c4_ctx *ctx, int player, int level, int *column, int *row)
+{
+	int best_column, goodness, real_player, result;
+
+	assert(ctx->game_in_progress);
+	assert(!ctx->move_in_progress);
+	assert(level >= 1 && level <= C4_MAX_LEVEL);
+
+	real_player = real_player(player);
+
+	if (ctx->engine == C4_ENGINE_RULE)
+		return rule_move(ctx, real_player, column, row);
+
+	if (opening_move(ctx, real_player, column, row))
+		return true;
+
+	ctx->move_in_progress = true;
+	reset_node_counts(ctx);
+	reset_move_ordering(ctx);
+	ctx->search_aborted = false;
+
+	best_column = search_level(ctx, real_player, level, true, &goodness);
+
+	ctx->move_in_progress = false;
+
+	/* Drop the piece in the column decided upon. */
+
+	if (best_column >= 0) {
+		result = drop_piece(&ctx->game_search, real_player, best_column);
+		if (column != NULL)
+			*column = best_column;
+		if (row != NULL)
+			*row = result;
+		return true;
+	}
+	else
+		return false;
+}
+
+
+
+/**
+* @function c4_ctx_auto_move_timed
+*
+* @param ctx  c4_ctx
+* @param player     (0) Ǵ ǻ(1)
+* @param budget_ms      ִ ð(и)
+* @param column    ǥ ϱ  Ǵ 
+* @param row    ǥ ϱ  Ǵ 
+* @return   尡    ڸ ٸ false ,
+*          Ҵٸ, true 
+*
+* level  δ c4_auto_move() ޸,  1  ð    ܰ辿   ŽѴ(iterative deepening).
+* budget_ms    ܰ    Ž ܰ   ´. ڼ  search_timed() ִ.
+* c4_set_engine() C4_ENGINE_RULE ٸ c4_auto_move()ó rule ´.
+* ð c4_poll()  poll_search() monotonic clock ȮϹǷ, ٸ thread process CPU  ð Եȴ.
+*/
+
+bool
+c4_ctx_auto_move_timed(c4_ctx *ctx, int player, int budget_ms, int *column, int *row)
+{
+	int best_column, goodness, depth, real_player, result;
+
+	assert(ctx->game_in_progress);
+	assert(!ctx->move_in_progress);
+	assert(budget_ms > 0);
+
+	real_player = real_player(player);
+
+	if (ctx->engine == C4_ENGINE_RULE)
+		return rule_move(ctx, real_player, column, row);
+	if (opening_move(ctx, real_player, column, row))
+		return true;
+
+	ctx->move_in_progress = true;
+	best_column = search_timed(ctx, real_player, budget_ms, &goodness, &depth);
+	ctx->move_in_progress = false;
+
+	if (best_column >= 0) {
+		result = drop_piece(&ctx->game_search, real_player, best_column);
+		if (column != NULL)
+			*column = best_column;
+		if (row != NULL)
+			*row = result;
+		return true;
+	}
+	else
+		return false;
+}
+
+
+
+/**
+* @function c4_ctx_search
+*
+* @param ctx  c4_ctx
+* @param player     (0) Ǵ ǻ(1)
+* @param level Ž Ʈ Ž  
+* @param goodness   column goodness ϱ  . NULL̸ Ѵ.
+* @return   column,   ִ column ų c4_stop() Ž ٸ -1
+*
+* c4_auto_move()   levelŭ Ž,   ʰ opening book  ʴ´.
+* book ų  мϴ α׷ Ѵ.
+*/
+
+int
+c4_ctx_search(c4_ctx *ctx, int player, int level, int *goodness)
+{
+	int best_column, best_goodness;
+	bool stopped;
+
+	assert(ctx->game_in_progress);
+	assert(!ctx->move_in_progress);
+	assert(level >= 1 && level <= C4_MAX_LEVEL);
+
+	ctx->move_in_progress = true;
+	reset_node_counts(ctx);
+	reset_move_ordering(ctx);
+	ctx->search_aborted = false;
+
+	best_column = search_level(ctx, real_player(player), level, false, &best_goodness);
+
+	stopped = ctx->search_aborted;
+	ctx->search_aborted = false;
+	ctx->move_in_progress = false;
+
+	if (stopped)
+		return -1;
+	if (goodness != NULL)
+		*goodness = best_goodness;
+	return best_column;
+}
+
+
+
+/**
+* @function c4_ctx_search_timed
+*
+* @param ctx  c4_ctx
+* @param player     (0) Ǵ ǻ(1)
+* @param budget_ms Ž   ִ ð(и)
+* @param goodness   column goodness ϱ  . NULL̸ Ѵ.
+* @param depth  Ž  ̸ ϱ  . NULL̸ Ѵ.
+* @return   column,   ִ column ٸ -1
+*
+* c4_auto_move_timed()   ð   ̸ ÷  Ž, c4_search()ó   ʴ´.
+*  1 Ž  ߴٸ depth 0̰, goodness ǹ̰ .
+* c4_stop() ߸ ð   Ͱ    Ž   Ѵ.
+*/
+
+int
+c4_ctx_search_timed(c4_ctx *ctx, int player, int budget_ms, int *goodness, int *depth)
+{
+	int best_column, best_goodness, best_depth;
+
+	assert(ctx->game_in_progress);
+	assert(!ctx->move_in_progress);
+	assert(budget_ms > 0);
+
+	ctx->move_in_progress = true;
+	best_column = search_timed(ctx, real_player(player), budget_ms, &best_goodness, &best_depth);
+	ctx->move_in_progress = false;
+
+	if (goodness != NULL)
+		*goodness = best_goodness;
+	if (depth != NULL)
+		*depth = best_depth;
+	return best_column;
+}
+
+
+
+/**
+* @function c4_ctx_board
+*
+* @param ctx  c4_ctx
+* @return    ¸ 2 char迭 
+*
+* ϴ 2 迭 column * row , 7*6 2 迭̴.
+*    0, ǻ   1, ƹ     C4_NONE(2) ä ִ.
+* Ž Ʈ常 ϹǷ,  迭 ȭ   ȣ  Ʈκ  ä.
+*  ϵ 迭  c4_board() ȣ  ȿϴ.
+*/
+
+char **
+c4_ctx_board(c4_ctx *ctx)
+{
+	int x, y;
+
+	assert(ctx->game_in_progress);
+
+	for (x = 0; x<size_x; x++) {
+		for (y = 0; y<size_y; y++)
+			ctx->display_cells[x][y] = (char)board_cell(ctx, x, y);
+		ctx->display_board[x] = ctx->display_cells[x];
+	}
+	return ctx->display_board;
+}
+
+
+
+/**
+* @function c4_ctx_score_of_player
+*
+* @param ctx  c4_ctx
+* @param player  score ˰  (0) Ǵ ǻ(1)
+* @return player score 
+*
+* score ִ   ӵ  ġ(Winning Position) 
+* player  迭 ϼϴµ 󸶳 ߴ   Ҹ Ͽ ġȭ ̴.
+*/
+
+int
+c4_ctx_score_of_player(c4_ctx *ctx, int player)
+{
+	assert(ctx->game_in_progress);
+	return ctx->current_state->score[real_player(player)];
+}
+
+
+
+
+/**
+* @function c4_ctx_is_winner
+*
+* @param ctx  c4_ctx
+* @param player ¿θ ˰  (0) Ǵ ǻ(1)
+* @return ߴٸ true, ƴϸ false
+*/
+
+bool
+c4_ctx_is_winner(c4_ctx *ctx, int player)
+{
+	assert(ctx->game_in_progress);
+	return (ctx->current_state->winner == real_player(player));
+}
+
+
+
+/**
+* @function c4_ctx_is_tie
+*
+* @param ctx  c4_ctx
+* @return  尡 ϼǾ ºζ true, ƴϸ false
+*/
+
+bool
+c4_ctx_is_tie(c4_ctx *ctx)
+{
+	assert(ctx->game_in_progress);
+	return (ctx->current_state->num_of_pieces == total_size &&
+		ctx->current_state->winner == C4_NONE);
+}
+
+
+
+
+/**
+* @function c4_ctx_win_coords
+*
+* @param ctx  c4_ctx
+* @param x1 ϴ ӵ 4    Ʒ   column ǥ
+* @param y1 ϴ ӵ 4    Ʒ   row ǥ
+* @param x2 ϴ ӵ 4       column ǥ
+* @param y2 ϴ ӵ 4       row ǥ
+*
+* C   ÿ ϴ  ҰϹǷ,
+*  Լ ִ  ּҸ parameter ޾   column row  
+*  ɾ  ʰ   Ѵ.
+*/
+
+void
+c4_ctx_win_coords(c4_ctx *ctx, int *x1, int *y1, int *x2, int *y2)
+{
+	int winner, win_pos;
+	uint32_t wins[SCORE_MASK_WORDS];
+
+	assert(ctx->game_in_progress);
+
+	winner = ctx->current_state->winner;
+	assert(winner != C4_NONE);
+
+	score_mask(ctx->current_state->score_array[winner], magic_win_number, wins);
+	win_pos = next_line(wins, 0);
+	assert(win_pos >= 0);
+
+	/* win_lines ĭ  Ʒ (backward diagonal  Ʒ ) ĭ Ǿ ִ. */
+
+	*x1 = win_lines[win_pos][0][0];
+	*y1 = win_lines[win_pos][0][1];
+	*x2 = win_lines[win_pos][num_to_connect - 1][0];
+	*y2 = win_lines[win_pos][num_to_connect - 1][1];
+}
+
+
+
+/**
+* @function c4_ctx_position_key
+*
+* @param ctx  c4_ctx
+* @param player     (0) Ǵ ǻ(1)
+* @param mirrored key ¿  忡 ߴٸ true  . NULL̸ Ѵ.
+* @return   key. ¿    ̴.
+*
+* opening book  key  ã´. mirrored true book  column ¿  Ѵ.
+*  WIDTH HEIGHT compile engine̶  process ص  ̴.
+*/
+
+uint64_t
+c4_ctx_position_key(c4_ctx *ctx, int player, bool *mirrored)
+{
+	bool flipped;
+	uint64_t key;
+
+	assert(ctx->game_in_progress);
+
+	key = position_key(ctx->current_state, real_player(player), &flipped);
+	if (mirrored != NULL)
+		*mirrored = flipped;
+	return key;
+}
+
+
+
+/**
+* @function c4_ctx_principal_variation
+*
+* @param ctx  c4_ctx
+* @param player     (0) Ǵ ǻ(1)
+* @param column Ž  column.   column Ѵ.
+* @param pv  column  迭
+* @param max_length pv   ִ column 
+* @return pv  column 
+*
+*  Ž  (principal variation) Ѵ.
+* column  ڷδ transposition table    best column 󰡸, table  ̳   .
+*   ٲپٰ ǵ ´.
+*/
+
+int
+c4_ctx_principal_variation(c4_ctx *ctx, int player, int column, int *pv, int max_length)
+{
+	Search_context *sc = &ctx->game_search;
+	Game_state *state = ctx->current_state;
+	Tt_entry entry;
+	bool mirrored;
+	int length = 0;
+
+	assert(ctx->game_in_progress);
+	assert(!ctx->move_in_progress);
+
+	player = real_player(player);
+	while (length < max_length && column >= 0 && column < WIDTH && !(state->mask & top_mask(column))) {
+		drop_piece(sc, player, column);
+		pv[length++] = column;
+		player = other(player);
+		if (state->winner != C4_NONE || state->num_of_pieces == total_size)
+			break;
+		if (!tt_probe(sc, position_key(state, player, &mirrored), &entry))
+			break;
+		column = (mirrored && entry.best_column >= 0) ? mirror_column(entry.best_column) : entry.best_column;
+	}
+
+	for (int i = 0; i < length; i++)
+		undo_piece(sc);
+	return length;
+}
+
+
+
+/**
+* @function c4_ctx_stop
+*
+* @param ctx  c4_ctx
+*
+* ٸ thread   Ž    ߰ Ѵ. Ž  thread ƴ  ҷ ȴ.
+* c4_search() -1, c4_search_timed() c4_auto_move_timed()   Ž   Ѵ.
+* Ž    û Ƿ, Ž ۵Ǳ  θ û õ  ִ.
+* ׷  ߷ c4_poll()  Լ ٽ θ ȴ.
+*/
+
+void
+c4_ctx_stop(c4_ctx *ctx)
+{
+	atomic_store(&ctx->search_aborted, true);
+}
+
+
+
+/**
+* @function c4_ctx_end_game
+*
+* @param ctx  c4_ctx
+*
+* ǰ ִ  Ѵ. map  ǥ ٸ ӵ  ϹǷ  ʴ´.
+*/
+
+void
+c4_ctx_end_game(c4_ctx *ctx)
+{
+	assert(ctx->game_in_progress);
+	assert(!ctx->move_in_progress);
+
+	ctx->game_in_progress = false;
+}
+
+
+
+/****************************************************************************/
+/**                                                                    	**/
+/**  The following functions are the original single-game interface.  	**/
+/**  Each one calls the c4_ctx_ function of the same name on one       	**/
+/**  default context, which is created the first time it is needed.    	**/
+/**                                                                    	**/
+/****************************************************************************/
+
+
+
+/**
+* @function c4_poll
+*
+* c4_ctx_poll() default_ctx  θ.
+*/
+
+void
+c4_poll(void(*poll_func)(void), clock_t interval)
+{
+	c4_ctx_poll(default_context(), poll_func, interval);
+}
+
+
+
+/**
+* @function c4_set_hash_size
+*
+* c4_ctx_set_hash_size() default_ctx  θ.
+*/
+
+void
+c4_set_hash_size(int megabytes)
+{
+	c4_ctx_set_hash_size(default_context(), megabytes);
+}
+
+
+
+/**
+* @function c4_hash_stats
+*
+* c4_ctx_hash_stats() default_ctx  θ.
+*/
+
+void
+c4_hash_stats(unsigned long *hits, unsigned long *misses, unsigned long *collisions)
+{
+	c4_ctx_hash_stats(default_context(), hits, misses, collisions);
+}
+
+
+
+/**
+* @function c4_cutoff_stats
+*
+* c4_ctx_cutoff_stats() default_ctx  θ.
+*/
+
+void
+c4_cutoff_stats(unsigned long *cutoffs, unsigned long *first_move_cutoffs)
+{
+	c4_ctx_cutoff_stats(default_context(), cutoffs, first_move_cutoffs);
+}
+
+
+
+/**
+* @function c4_get_search_stats
+*
+* c4_ctx_get_search_stats() default_ctx  θ.
+*/
+
+void
+c4_get_search_stats(c4_search_stats *stats)
+{
+	c4_ctx_get_search_stats(default_context(), stats);
+}
+
+
+
+/**
+* @function c4_set_solver_threshold
+*
+* c4_ctx_set_solver_threshold() default_ctx  θ.
+*/
+
+void
+c4_set_solver_threshold(int empty_cells)
+{
+	c4_ctx_set_solver_threshold(default_context(), empty_cells);
+}
+
+
+
+/**
+* @function c4_set_threads
+*
+* c4_ctx_set_threads() default_ctx  θ.
+*/
+
+void
+c4_set_threads(int threads)
+{
+	c4_ctx_set_threads(default_context(), threads);
+}
+
+
+
+/**
+* @function c4_set_smp_mode
+*
+* c4_ctx_set_smp_mode() default_ctx  θ.
+*/
+
+void
+c4_set_smp_mode(int mode)
+{
+	c4_ctx_set_smp_mode(default_context(), mode);
+}
+
+
+
+/**
+* @function c4_set_search_mode
+*
+* c4_ctx_set_search_mode() default_ctx  θ.
+*/
+
+void
+c4_set_search_mode(int mode)
+{
+	c4_ctx_set_search_mode(default_context(), mode);
+}
+
+
+
+/**
+* @function c4_set_engine
+*
+* c4_ctx_set_engine() default_ctx  θ.
+*/
+
+void
+c4_set_engine(int engine)
+{
+	c4_ctx_set_engine(default_context(), engine);
+}
+
+
+
+/**
+* @function c4_set_trace
+*
+* c4_ctx_set_trace() default_ctx  θ.
+*/
+
+void
+c4_set_trace(c4_trace_func trace_func, void *data)
+{
+	c4_ctx_set_trace(default_context(), trace_func, data);
+}
+
+
+
+/**
+* @function c4_load_book
+*
+* c4_ctx_load_book() default_ctx  θ.
+*/
+
+bool
+c4_load_book(const char *path)
+{
+	return c4_ctx_load_book(default_context(), path);
+}
+
+
+
+/**
+* @function c4_open_solved_cache
+*
+* c4_ctx_open_solved_cache() default_ctx  θ.
+*/
+
+bool
+c4_open_solved_cache(const char *path, int megabytes)
+{
+	return c4_ctx_open_solved_cache(default_context(), path, megabytes);
+}
+
+
+
+/**
+* @function c4_thread_nodes
+*
+* c4_ctx_thread_nodes() default_ctx  θ.
+*/
+
+unsigned long
+c4_thread_nodes(int thread)
+{
+	return c4_ctx_thread_nodes(default_context(), thread);
+}
+
+
+
+/**
+* @function c4_new_game
+*
+* c4_ctx_new_game() default_ctx  θ.
+*/
+
+void
+c4_new_game(void)
+{
+	c4_ctx_new_game(default_context());
+}
+
+
+
+/**
+* @function c4_make_move
+*
+* c4_ctx_make_move() default_ctx  θ.
+*/
+
+bool
+c4_make_move(int player, int column, int row)
+{
+	return c4_ctx_make_move(default_context(), player, column, row);
+}
+
+
+
+/**
+* @function c4_rule_auto_move
+*
+* c4_ctx_rule_auto_move() default_ctx  θ.
+*/
+
+void
+c4_rule_auto_move(int player, int *column, int *row)
+{
+	c4_ctx_rule_auto_move(default_context(), player, column, row);
+}
+
+
+
+/**
+* @function c4_auto_move
+*
+* c4_ctx_auto_move() default_ctx  θ.
+*/
+
+bool
+c4_auto_move(int player, int level, int *column, int *row)
+{
+	return c4_ctx_auto_move(default_context(), player, level, column, row);
+}
+
+
+
+/**
+* @function c4_auto_move_timed
+*
+* c4_ctx_auto_move_timed() default_ctx  θ.
+*/
+
+bool
+c4_auto_move_timed(int player, int budget_ms, int *column, int *row)
+{
+	return c4_ctx_auto_move_timed(default_context(), player, budget_ms, column, row);
+}
+
+
+
+/**
+* @function c4_board
+*
+* c4_ctx_board() default_ctx  θ.
+*/
+
+char **
+c4_board(void)
+{
+	return c4_ctx_board(default_context());
+}
+
+
+
+/**
+* @function c4_score_of_player
+*
+* c4_ctx_score_of_player() default_ctx  θ.
+*/
+
+int
+c4_score_of_player(int player)
+{
+	return c4_ctx_score_of_player(default_context(), player);
+}
+
+
+
+/**
+* @function c4_is_winner
+*
+* c4_ctx_is_winner() default_ctx  θ.
+*/
+
+bool
+c4_is_winner(int player)
+{
+	return c4_ctx_is_winner(default_context(), player);
+}
+
+
+
+/**
+* @function c4_is_tie
+*
+* c4_ctx_is_tie() default_ctx  θ.
+*/
+
+bool
+c4_is_tie(void)
+{
+	return c4_ctx_is_tie(default_context());
+}
+
+
+
+/**
+* @function c4_win_coords
+*
+* c4_ctx_win_coords() default_ctx  θ.
+*/
+
+void
+c4_win_coords(int *x1, int *y1, int *x2, int *y2)
+{
+	c4_ctx_win_coords(default_context(), x1, y1, x2, y2);
+}
+
+
+
+/**
+* @function c4_search
+*
+* c4_ctx_search() default_ctx  θ.
+*/
+
+int
+c4_search(int player, int level, int *goodness)
+{
+	return c4_ctx_search(default_context(), player, level, goodness);
+}
+
+
+
+/**
+* @function c4_search_timed
+*
+* c4_ctx_search_timed() default_ctx  θ.
+*/
+
+int
+c4_search_timed(int player, int budget_ms, int *goodness, int *depth)
+{
+	return c4_ctx_search_timed(default_context(), player, budget_ms, goodness, depth);
+}
+
+
+
+/**
+* @function c4_position_key
+*
+* c4_ctx_position_key() default_ctx  θ.
+*/
+
+uint64_t
+c4_position_key(int player, bool *mirrored)
+{
+	return c4_ctx_position_key(default_context(), player, mirrored);
+}
+
+
+
+/**
+* @function c4_principal_variation
+*
+* c4_ctx_principal_variation() default_ctx  θ.
+*/
+
+int
+c4_principal_variation(int player, int column, int *pv, int max_length)
+{
+	return c4_ctx_principal_variation(default_context(), player, column, pv, max_length);
+}
+
+
+
+/**
+* @function c4_stop
+*
+* c4_ctx_stop() default_ctx  θ.
+*/
+
+void
+c4_stop(void)
+{
+	c4_ctx_stop(default_context());
+}
+
+
+
+/**
+* @function c4_end_game
+*
+* c4_ctx_end_game() default_ctx  θ.
+*/
+
+void
+c4_end_game(void)
+{
+	c4_ctx_end_game(default_context());
+}
+
+
+
+/****************************************************************************/
+/****************************************************************************/
+/**                                                                    	**/
+/**  The following functions are local to this file and should not be  	**/
+/**  called externally.                                                	**/
+/**                                                                    	**/
+/****************************************************************************/
+/****************************************************************************/
+
+
+
+/**
+* @function num_of_win_places
+*
+* @param x ϰ ִ   column 
+* @param y ϰ ִ   row 
+* @param n ӵǰ ؾ ϴ  
+* @return ش  忡    ӵ  (Winning Position) 
+*/
+
+static int
+num_of_win_places(int x, int y, int n) // num_of_win_places(6, 7, 4)
+{
+	if (x < n && y < n)
+		return 0;
+	else if (x < n)
+		return x * ((y - n) + 1);
+	else if (y < n)
+		return y * ((x - n) + 1);
+	else // ׻ . return 69.
+		return 4 * x*y - 3 * x*n - 3 * y*n + 3 * x + 3 * y - 4 * n + 2 * n*n + 2;
+}
+
+
+
+/**
+* @function update_score
+*
+* @param state score  Ʈ Game_state
+* @param player  score  Ʈϰ  (0) Ǵ ǻ(1)
+* @param x Է  ּ 
+* @param y Է  ִ 
+* @param undo ٲ   score_array   Undo_record
+*
+*  ¿ player column x, row y ڸ   ,  score  ƮѴ.
+*/
+
+static void
+update_score(Game_state *state, int player, int x, int y, Undo_record *undo)
+{
+	register int i;
+	int win_index;
+	int this_difference = 0, other_difference = 0;
+	int8_t (*current_score_array)[SCORE_STRIDE] = state->score_array;
+	int other_player = other(player);
+
+	const uint8_t *lines = &map_lines[map_begin(x, y)];
+	int num_of_lines = map_end(x, y) - map_begin(x, y);
+
+	for (i = 0; i < num_of_lines; i++) {
+		win_index = lines[i];
+		this_difference += current_score_array[player][win_index];
+		other_difference += current_score_array[other_player][win_index];
+		undo->other_scores[i] = current_score_array[other_player][win_index];
+
+		current_score_array[player][win_index] <<= 1;
+		current_score_array[other_player][win_index] = 0;
+	}
+
+	state->score[player] += this_difference;
+	state->score[other_player] -= other_difference;
+}
+
+
+
+/**
+* @function drop_piece
+*
+* @param sc   Search_context
+* @param player (0) Ǵ ǻ(1)
+* @param column   column 
+* @return   Ҵٸ,   ǥ row  
+*		      ߴٸ, -1 Ѵ.
+*
+* Է¹ player  Է¹ columnٰ  Լ̴.
+* column    ĭ mask bottom_mask    ϰ,
+* ¸ δ has_alignment() shift  ˻ϹǷ column  ʴ´.
+*   sc undo_log ϵǾ undo_piece() ǵ  ִ.
+*/
+
+static int
+drop_piece(Search_context *sc, int player, int column)
+{
+	int y;
+	uint64_t move;
+	Undo_record *undo;
+	Game_state *state = &sc->state;
+
+	if (state->mask & top_mask(column))
+		return -1;
+
+	y = popcount64(state->mask & column_mask(column));
+	move = (state->mask + bottom_mask(column)) & column_mask(column);
+
+	undo = &sc->undo_log[state->num_of_pieces];
+	undo->move = move;
+	undo->score[0] = state->score[0];
+	undo->score[1] = state->score[1];
+	undo->winner = state->winner;
+	undo->player = (char)player;
+	undo->column = (char)column;
+	undo->row = (char)y;
+
+	state->mask |= move;
+	if (player == 0)
+		state->position |= move;
+	state->num_of_pieces++;
+	state->hash ^= zobrist[player][column * COLUMN_BITS + y];
+	state->hash_mirror ^= zobrist[player][mirror_column(column) * COLUMN_BITS + y];
+	update_score(state, player, column, y, undo);
+
+	if (state->winner == C4_NONE && has_alignment(player_bits(state, player)))
+		state->winner = player;
+
+	sc->depth++;
+	return y;
+}
+
+
+
+/**
+* @function undo_piece
+*
+* @param sc  ǵ Search_context
+*
+*   drop_piece()   undo_log  ̿ ǵ.
+*  ü ϴ  map[column][row] شϴ win place鸸 ġ ȴ.
+*/
+
+static void
+undo_piece(Search_context *sc)
+{
+	register int i;
+	int win_index, player, other_player, num_of_lines;
+	const uint8_t *lines;
+	Game_state *state = &sc->state;
+	int8_t (*current_score_array)[SCORE_STRIDE] = state->score_array;
+	Undo_record *undo;
+
+	undo = &sc->undo_log[--state->num_of_pieces];
+	player = undo->player;
+	other_player = other(player);
+
+	lines = &map_lines[map_begin(undo->column, undo->row)];
+	num_of_lines = map_end(undo->column, undo->row) - map_begin(undo->column, undo->row);
+	for (i = 0; i < num_of_lines; i++) {
+		win_index = lines[i];
+		current_score_array[player][win_index] >>= 1;
+		current_score_array[other_player][win_index] = undo->other_scores[i];
+	}
+
+	state->score[0] = undo->score[0];
+	state->score[1] = undo->score[1];
+	state->winner = undo->winner;
+
+	state->mask ^= undo->move;
+	if (player == 0)
+		state->position ^= undo->move;
+	state->hash ^= zobrist[player][undo->column * COLUMN_BITS + undo->row];
+	state->hash_mirror ^= zobrist[player][mirror_column(undo->column) * COLUMN_BITS + undo->row];
+
+	sc->depth--;
+}
+
+
+
+/**
+* @function popcount64
+*
+* @param bits Ʈ
+* @return bits 1 Ʈ 
+*/
+
+static int
+popcount64(uint64_t bits)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_popcountll(bits);
+#else
+	int count = 0;
+
+	for (; bits; bits &= bits - 1)
+		count++;
+	return count;
+#endif
+}
+
+
+
+/**
+* @function has_alignment
+*
+* @param bits  player   ĭ Ʈ
+* @return , ,  밢   ε 4  ӵǾ ִٸ true
+*
+* ⸶ Ʈ带  ĭ shiftؼ ANDϸ ӵ  ĭ ,
+* ̸ ٽ  ĭ shiftؼ ANDϸ ӵ  ĭ  ġ ´.
+*/
+
+static bool
+has_alignment(uint64_t bits)
+{
+	uint64_t m;
+
+	/* horizontal */
+	m = bits & (bits >> COLUMN_BITS);
+	if (m & (m >> (2 * COLUMN_BITS)))
+		return true;
+
+	/* forward diagonal */
+	m = bits & (bits >> (COLUMN_BITS + 1));
+	if (m & (m >> (2 * (COLUMN_BITS + 1))))
+		return true;
+
+	/* backward diagonal */
+	m = bits & (bits >> (COLUMN_BITS - 1));
+	if (m & (m >> (2 * (COLUMN_BITS - 1))))
+		return true;
+
+	/* vertical */
+	m = bits & (bits >> 1);
+	if (m & (m >> 2))
+		return true;
+
+	return false;
+}
+
+
+
+/**
+* @function score_mask_scalar
+*
+* @param scores  player score_array
+* @param value ã score . þ ĭ ϱ  0 ƴϾ Ѵ.
+* @param mask win place  Ʈ, SCORE_MASK_WORDS word   迭
+*
+* scores  value win place Ʈ mask Ҵ.
+* SIMD ɾ    CPU  ̴.
+*/
+
+static void
+score_mask_scalar(const int8_t *scores, int value, uint32_t *mask)
+{
+	int i;
+
+	for (i = 0; i < SCORE_MASK_WORDS; i++)
+		mask[i] = 0;
+	for (i = 0; i < win_places; i++)
+		if (scores[i] == value)
+			mask[i / 32] |= (uint32_t)1 << (i % 32);
+}
+
+
+
+#ifdef HAVE_X86_SIMD
+
+/**
+* @function score_mask_sse2
+*
+* score_mask_scalar() . 16Ʈ ؼ    word .
+*/
+
+__attribute__((target("sse2")))
+static void
+score_mask_sse2(const int8_t *scores, int value, uint32_t *mask)
+{
+	__m128i key = _mm_set1_epi8((char)value);
+	int i;
+
+	for (i = 0; i < SCORE_MASK_WORDS; i++) {
+		__m128i low = _mm_load_si128((const __m128i *)(scores + 32 * i));
+		__m128i high = _mm_load_si128((const __m128i *)(scores + 32 * i + 16));
+
+		mask[i] = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(low, key))
+			| (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(high, key)) << 16;
+	}
+}
+
+
+
+/**
+* @function score_mask_avx2
+*
+* score_mask_scalar() . 32Ʈ   ؼ  word .
+* score_array 16Ʈ ĸ ǹǷ ĵ  load .
+*/
+
+__attribute__((target("avx2")))
+static void
+score_mask_avx2(const int8_t *scores, int value, uint32_t *mask)
+{
+	__m256i key = _mm256_set1_epi8((char)value);
+	int i;
+
+	for (i = 0; i < SCORE_MASK_WORDS; i++) {
+		__m256i lanes = _mm256_loadu_si256((const __m256i *)(scores + 32 * i));
+
+		mask[i] = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lanes, key));
+	}
+}
+
+#endif
+
+
+
+/**
+* @function has_line
+*
+* @param mask score_mask()  Ʈũ
+* @param win_index win place ȣ
+* @return mask win_index Ʈ  ִٸ true
+*/
+
+static bool
+has_line(const uint32_t *mask, int win_index)
+{
+	return (mask[win_index / 32] >> (win_index % 32)) & 1;
+}
+
+
+
+/**
+* @function next_line
+*
+* @param mask score_mask()  Ʈũ
+* @param from ã  win place ȣ
+* @return from ̸̻鼭 mask Ʈ    win place ȣ. ٸ -1
+*/
+
+static int
+next_line(const uint32_t *mask, int from)
+{
+	int word = from / 32;
+	uint32_t bits;
+
+	if (from >= SCORE_STRIDE)
+		return -1;
+	bits = mask[word] & (~(uint32_t)0 << (from % 32));
+	while (bits == 0) {
+		if (++word == SCORE_MASK_WORDS)
+			return -1;
+		bits = mask[word];
+	}
+#if defined(__GNUC__) || defined(__clang__)
+	return word * 32 + __builtin_ctz(bits);
+#else
+	for (from = word * 32; !(bits & 1); bits >>= 1)
+		from++;
+	return from;
+#endif
+}
+
+
+
+/**
+* @function board_cell
+*
+* @param x ˰  ĭ column ǥ
+* @param y ˰  ĭ row ǥ
+* @return ش ĭ    0 Ǵ 1,  ִٸ C4_NONE
+*
+* Rule Լ ĭ  带   Ѵ.
+*   ĭ  ִ (C4_NONE) , ٴ Ʒ(y < 0)
+* "Ʒ ä ִ" ˻簡 ڿ ϵ  player  ƴ  ش.
+*/
+
+static int
+board_cell(const c4_ctx *ctx, int x, int y)
+{
+	uint64_t cell;
+
+	if (y < 0)
+		return C4_NONE + 1;
+	if (x < 0 || x >= size_x || y >= size_y)
+		return C4_NONE;
+
+	cell = cell_mask(x, y);
+	if (!(ctx->current_state->mask & cell))
+		return C4_NONE;
+	return (ctx->current_state->position & cell) ? 0 : 1;
+}
+
+
+
+/**
+* @function column_height
+*
+* @param state ̸ ˰  Game_state
+* @param column ̸ ˰  column
+* @return column   .     row ̸,  áٸ size_y
+*/
+
+static int
+column_height(const Game_state *state, int column)
+{
+	return popcount64(state->mask & column_mask(column));
+}
+
+
+
+/**
+* @function opening_move
+*
+* @param player (0) Ǵ ǻ(1)
+* @param column    ǥ ϱ  Ǵ 
+* @param row    ǥ ϱ  Ǵ 
+* @return book ִ ̰ų ù    ϳ Ž   Ҵٸ true, ƴ϶ false
+*
+*   opening book ִٸ book column ´.
+* book ٸ ù  2 Ǵ 4 column  random,  °   column ´.
+*/
+
+static bool
+opening_move(c4_ctx *ctx, int player, int *column, int *row)
+{
+	int result, current_column;
+
+	if (book_move(ctx, player, &current_column))
+		;
+	else if (ctx->current_state->num_of_pieces >= 2)
+		return false;
+	else if (ctx->current_state->num_of_pieces == 0)
+		current_column = (rand() % 2 == 0) ? 2 : 4;
+	else
+		current_column = 3;
+
+	result = drop_piece(&ctx->game_search, player, current_column);
+	if (column != NULL)
+		*column = current_column;
+	if (row != NULL)
+		*row = result;
+	return true;
+}
+
+
+
+/**
+* @function rule_move
+*
+* @return   ִ column ־ rule  Ҵٸ true, 尡  áٸ false
+*
+* C4_ENGINE_RULE  c4_auto_move() c4_auto_move_timed() c4_rule_auto_move()  θ.
+* 尡  áٸ rule  column ã ϹǷ  ȮѴ.
+*/
+
+static bool
+rule_move(c4_ctx *ctx, int player, int *column, int *row)
+{
+	int found_column = -1, found_row = -1;
+
+	if (ctx->current_state->num_of_pieces == total_size)
+		return false;
+
+	c4_ctx_rule_auto_move(ctx, player, &found_column, &found_row);
+	if (column != NULL)
+		*column = found_column;
+	if (row != NULL)
+		*row = found_row;
+	return true;
+}
+
+
+
+/**
+* @function book_move
+*
+* @param player     (0) Ǵ ǻ(1)
+* @param column book ã column  
+* @return   book ְ  column    ִٸ true
+*
+* book key  ĵǾ Ƿ ̺ Ž ã´.
+* book column key    ̹Ƿ,  带  key ߴٸ column ´.
+*/
+
+static bool
+book_move(c4_ctx *ctx, int player, int *column)
+{
+	size_t low = 0, high = ctx->book_entries, middle;
+	uint64_t key;
+	bool mirrored;
+	int found;
+
+	if (ctx->book_entries == 0)
+		return false;
+
+	key = position_key(ctx->current_state, player, &mirrored);
+	while (low < high) {
+		middle = low + (high - low) / 2;
+		if (ctx->book[middle].key < key)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	if (low == ctx->book_entries || ctx->book[low].key != key)
+		return false;
+
+	found = ctx->book[low].column;
+	if (found >= WIDTH)
+		return false;
+	if (mirrored)
+		found = mirror_column(found);
+	if (ctx->current_state->mask & top_mask(found))
+		return false;
+	*column = found;
+	return true;
+}
+
+
+
+/**
+* @function unload_book
+*
+* c4_ctx_load_book()  book ִٸ ݴ´.
+*/
+
+static void
+unload_book(c4_ctx *ctx)
+{
+	if (ctx->book_map != NULL) {
+#if HAVE_MMAP
+		if (ctx->book_mapped)
+			munmap(ctx->book_map, ctx->book_map_size);
+		else
+#endif
+			free(ctx->book_map);
+	}
+	ctx->book_map = NULL;
+	ctx->book_map_size = 0;
+	ctx->book_mapped = false;
+	ctx->book = NULL;
+	ctx->book_entries = 0;
+}
+
+
+
+#if HAVE_SOLVED_CACHE
+/**
+* @function create_solved_cache
+*
+* @param path  solved cache  
+* @param megabytes  ũ. 0̸ SOLVED_DEFAULT_MB.
+* @return а   ְ   descriptor, ϸ -1
+*
+* ĭ   cache process ٸ ̸ ӽ Ͽ  ũ    path link()Ѵ.
+* ׻ ٸ process  path ٸ link() ϹǷ, ڽ     .
+*/
+
+static int
+create_solved_cache(const char *path, int megabytes)
+{
+	Solved_header header;
+	size_t bytes, slots;
+	char *temp;
+	int fd;
+
+	bytes = (size_t)(megabytes > 0 ? megabytes : SOLVED_DEFAULT_MB) * 1024 * 1024;
+	for (slots = 1; slots * 2 * sizeof(Tt_slot) <= bytes; slots *= 2)
+		;
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, SOLVED_MAGIC, sizeof(header.magic));
+	header.version = SOLVED_VERSION;
+	header.width = WIDTH;
+	header.height = HEIGHT;
+	header.slots = slots;
+
+	temp = (char *)emalloc(strlen(path) + 32);
+	sprintf(temp, "%s.%ld.tmp", path, (long)getpid());
+	fd = open(temp, O_RDWR | O_CREAT | O_EXCL, 0644);
+	if (fd < 0) {
+		free(temp);
+		return -1;
+	}
+	/*  byte   ̴ 0 ä. */
+	if (write(fd, &header, sizeof(header)) != (ssize_t)sizeof(header) ||
+		lseek(fd, (off_t)(slots * sizeof(Tt_slot) - 1), SEEK_CUR) < 0 ||
+		write(fd, "", 1) != 1 ||
+		fsync(fd) < 0 ||
+		link(temp, path) < 0) {
+		close(fd);
+		fd = (errno == EEXIST) ? open(path, O_RDWR) : -1;
+	}
+	unlink(temp);
+	free(temp);
+	return fd;
+}
+#endif
+
+
+
+/**
+* @function close_solved_cache
+*
+* c4_ctx_open_solved_cache()  cache ִٸ ݴ´. ̹   Ͽ ´.
+*/
+
+static void
+close_solved_cache(c4_ctx *ctx)
+{
+#if HAVE_SOLVED_CACHE
+	if (ctx->solved_map != NULL)
+		munmap(ctx->solved_map, ctx->solved_map_size);
+#endif
+	ctx->solved_map = NULL;
+	ctx->solved_map_size = 0;
+	ctx->solved_table = NULL;
+	ctx->solved_size = 0;
+}
+
+
+
+/**
+* @function search_level
+*
+* @param player (0) Ǵ ǻ(1)
+* @param level Ž Ʈ Ž  
+* @param report true Ž  trace Լ ˸
+* @param best_goodness   column goodness ϱ  
+* @return   column,   ִ column ٸ -1
+*
+* c4_set_search_mode()   root levelŭ Žϰ,  goodness MTD(f)   Ѵ.
+*/
+
+static int
+search_level(c4_ctx *ctx, int player, int level, bool report, int *best_goodness)
+{
+	int best_column;
+
+	if (ctx->search_mode == C4_SEARCH_MTDF)
+		best_column = mtdf_root(ctx, player, level, report, best_goodness);
+	else if (ctx->search_mode == C4_SEARCH_ASPIRATION)
+		best_column = aspiration_root(ctx, player, level, report, best_goodness);
+	else
+		best_column = search_root(ctx, player, level, -1, report, -(INT_MAX), INT_MAX, best_goodness);
+	ctx->last_goodness[player] = *best_goodness;
+	return best_column;
+}
+
+
+
+/**
+* @function search_timed
+*
+* @param player (0) Ǵ ǻ(1)
+* @param budget_ms Ž   ִ ð(и)
+* @param best_goodness   Ž ̿   column goodness ϱ  
+* @param depth   Ž ̸ ϱ  
+* @return   column,   ִ column ٸ -1
+*
+* c4_auto_move_timed() c4_search_timed() Բ ϴ iterative deepening̴.
+*  ܰ迡  ܰ ּ column   Žϰ,   transposition table   ܰ Ž  ´.
+* budget_ms    ܰ    Ž ܰ  Ѵ.
+* а Ȯ  ų,  column solver ǮȰų, C4_MAX_LEVEL ϸ ð Ƶ .
+*/
+
+static int
+search_timed(c4_ctx *ctx, int player, int budget_ms, int *best_goodness, int *depth)
+{
+	int best_column = -1, column_found, goodness, level;
+	int Hdrop_order[7];
+
+	reset_node_counts(ctx);
+	reset_move_ordering(ctx);
+	ctx->search_aborted = false;
+	ctx->search_deadline = monotonic_ns() + (int64_t)budget_ms * 1000000;
+	ctx->deadline_set = true;
+	*best_goodness = 0;
+	*depth = 0;
+
+	for (level = 1; level <= C4_MAX_LEVEL && level <= total_size - ctx->current_state->num_of_pieces; level++) {
+		column_found = search_root(ctx, player, level, best_column, false, -(INT_MAX), INT_MAX, &goodness);
+		if (ctx->search_aborted)
+			break;
+		best_column = column_found;
+		*best_goodness = goodness;
+		*depth = level;
+		if (goodness > WIN_SCORE_BOUND || goodness < -WIN_SCORE_BOUND)
+			break; /* а ȮǾǷ    ʿ䰡 . */
+		if (total_size - ctx->current_state->num_of_pieces - 1 <= ctx->solver_threshold)
+			break; /*  column solver Ǿ. */
+	}
+
+	ctx->deadline_set = false;
+	ctx->search_aborted = false;
+
+	/*  1 Ž  ߴٸ heuristic  ù ° column . */
+	if (best_column < 0) {
+		heuristicDropOrder(ctx, player, Hdrop_order);
+		for (int i = 0; i<size_x && best_column < 0; i++)
+			if (!(ctx->current_state->mask & top_mask(Hdrop_order[i])))
+				best_column = Hdrop_order[i];
+	}
+	return best_column;
+}
+
+
+
+/**
+* @function search_root
+*
+* @param player (0) Ǵ ǻ(1)
+* @param level Ž Ʈ Ž  
+* @param first_column   Ž column, ٸ -1
+* @param report true column  goodness trace Լ ˸.  window ̶ ˸ ʴ´
+* @param alpha root goodness   ۴ٸ Ȯ   Ѱ ص ȴ
+* @param beta root goodness   ũٸ Ѱ ص ȴ
+* @param best_goodness   column goodness ϱ  
+* @return   column,   ִ column ٸ -1
+*
+*  column    evaluate()     column ã´.
+* 尡 ¿ Ī̶    column    column ŽѴ.
+* best_goodness alpha ̻ beta ϶ Ȯ ̰, beta ũٸ Ѱ, alpha ۴ٸ Ѱ̴.
+*    ʴ´. Ž  ð  Ǹ search_aborted true ǰ, ׶ ϰ ǹ̰ .
+* c4_set_threads() thread   ̻ ߴٸ c4_set_smp_mode()   thread Բ ŽѴ.
+*/
+
+static int
+search_root(c4_ctx *ctx, int player, int level, int first_column, bool report, int alpha, int beta, int *best_goodness)
+{
+	Root_job job;
+	int current_column, i;
+	int Hdrop_order[7];
+	bool symmetric = is_symmetric(ctx->current_state), listed[WIDTH] = { false };
+
+	job.root = ctx->current_state;
+	job.player = player;
+	job.level = level;
+	job.alpha = alpha;
+	job.beta = beta;
+	job.num_columns = 0;
+	job.best_index = -1;
+	atomic_init(&job.next, 0);
+	atomic_init(&job.best_worst, -(INT_MAX));
+	job.lazy = (ctx->smp_mode == C4_SMP_LAZY);
+
+	/* Simulate a drop in each of the columns and see what the results are. */
+
+	heuristic_drop_order(ctx->current_state, player, Hdrop_order);    //Į      Į  Ŀ minmax Ž   Ѵ.
+	for (i = -1; i<size_x; i++) {
+		current_column = (i < 0) ? first_column : Hdrop_order[i];
+		if (current_column < 0 || (i >= 0 && current_column == first_column))
+			continue;
+
+		/* If this column is full, ignore it as a possibility. */
+		if (ctx->current_state->mask & top_mask(current_column))
+			continue;
+
+		/* Ī 鿡 ݴ column ̹ ־ٸ  Ƿ ǳʶڴ. */
+		if (symmetric && listed[mirror_column(current_column)])
+			continue;
+
+		/* If this drop wins the game, take it! */
+		if (has_alignment(player_bits(ctx->current_state, player) |
+			((ctx->current_state->mask + bottom_mask(current_column)) & column_mask(current_column)))) {
+			*best_goodness = INT_MAX - 1;
+			return current_column;
+		}
+
+		job.columns[job.num_columns++] = current_column;
+		listed[current_column] = true;
+	}
+
+	/* Otherwise, look ahead to see how good each move may turn out */
+	/* to be (assuming the opponent makes the best moves possible). */
+
+	mtx_init(&job.lock, mtx_plain);
+	reset_poll(ctx);
+	if (ctx->num_threads > 1 && job.num_columns > 1) {
+		mtx_lock(&ctx->pool_lock);
+		ctx->pool_job = &job;
+		ctx->pool_busy = ctx->num_threads - 1;
+		ctx->pool_generation++;
+		cnd_broadcast(&ctx->pool_wake);
+		mtx_unlock(&ctx->pool_lock);
+
+		run_root_job(&ctx->search_contexts[0], &job);
+		ctx->helpers_stop = true;
+
+		mtx_lock(&ctx->pool_lock);
+		while (ctx->pool_busy > 0)
+			cnd_wait(&ctx->pool_done, &ctx->pool_lock);
+		ctx->pool_job = NULL;
+		mtx_unlock(&ctx->pool_lock);
+		ctx->helpers_stop = false;
+	}
+	else
+		run_root_job(&ctx->search_contexts[0], &job);
+
+	for (i = 0; i < ctx->num_threads; i++) {
+		ctx->tt_hits += ctx->search_contexts[i].tt_hits;
+		ctx->tt_misses += ctx->search_contexts[i].tt_misses;
+		ctx->tt_collisions += ctx->search_contexts[i].tt_collisions;
+		ctx->search_contexts[i].tt_hits = ctx->search_contexts[i].tt_misses = ctx->search_contexts[i].tt_collisions = 0;
+		ctx->cutoffs += ctx->search_contexts[i].cutoffs;
+		ctx->first_move_cutoffs += ctx->search_contexts[i].first_move_cutoffs;
+		ctx->search_contexts[i].cutoffs = ctx->search_contexts[i].first_move_cutoffs = 0;
+	}
+
+	*best_goodness = atomic_load(&job.best_worst);
+
+	/* window  Ž ٽ Ž ̹Ƿ ˸ ʴ´. */
+	if (report && !ctx->search_aborted && *best_goodness >= alpha && *best_goodness <= beta) {
+		c4_trace_event event = { .kind = C4_TRACE_COLUMN };
+
+		for (i = 0; i < job.num_columns; i++) {
+			event.column = job.columns[i];
+			event.goodness = job.goodness[i];
+			trace_event(ctx, &event);
+		}
+		memset(&event, 0, sizeof(event));
+		event.kind = C4_TRACE_THREAD;
+		for (i = 0; i < ctx->num_threads && ctx->num_threads > 1; i++) {
+			event.thread = i;
+			event.nodes = ctx->search_contexts[i].nodes;
+			trace_event(ctx, &event);
+		}
+	}
+	mtx_destroy(&job.lock);
+
+	return (job.best_index >= 0) ? job.columns[job.best_index] : -1;
+}
+
+
+
+/**
+* @function mtdf_root
+*
+* @param player (0) Ǵ ǻ(1)
+* @param level Ž Ʈ Ž  
+* @param report true root   Žߴ goodness trace Լ ˸
+* @param best_goodness   column goodness ϱ  
+* @return   column,   ִ column ٸ -1
+*
+* MTD(f). player    goodness  ,   ϳ window search_root() θ.
+*   ũ Ѱ,  Ѱ ǹǷ,      Ѱ Ѱ   ǮѴ.
+* Ѱ  Ž column   column ƴ  Ƿ, Ѱ̳ Ȯ   Ž column .
+*  Ž  transposition table  Ƿ  Ž κ   ٽ Ѵ.
+*/
+
+static int
+mtdf_root(c4_ctx *ctx, int player, int level, bool report, int *best_goodness)
+{
+	int lower = -(INT_MAX), upper = INT_MAX;
+	int guess = ctx->last_goodness[player], goodness = guess;
+	int best_column = -1, column_found = -1, passes = 0;
+
+	while (lower < upper) {
+		column_found = search_root(ctx, player, level, column_found, false, guess, guess, &goodness);
+		passes++;
+		if (ctx->search_aborted)
+			break;
+		if (goodness >= guess)
+			best_column = column_found;
+		if (goodness > guess)
+			lower = goodness;
+		else if (goodness < guess)
+			upper = goodness;
+		else
+			lower = upper = goodness;
+		guess = goodness;
+	}
+	if (best_column < 0)
+		best_column = column_found;
+
+	if (report && !ctx->search_aborted) {
+		c4_trace_event event = { .kind = C4_TRACE_MTDF };
+
+		event.passes = passes;
+		event.goodness = goodness;
+		trace_event(ctx, &event);
+	}
+	*best_goodness = goodness;
+	return best_column;
+}
+
+
+
+/**
+* @function aspiration_root
+*
+* @param player (0) Ǵ ǻ(1)
+* @param level Ž Ʈ Ž  
+* @param report true  Ž column  goodness Ѵ
+* @param best_goodness   column goodness ϱ  
+* @return   column,   ִ column ٸ -1
+*
+* level - 2  Ž goodness ϰ,   ASPIRATION_WINDOWŭ window level ŽѴ.
+*  player ʿ     ŽϹǷ  goodness ũ ٸ ʰ,  window п cutoff .
+*  window ۰ų ũ    ٽ Žϸ,       .
+*  Ž и ãҴٸ window  ŽѴ.
+* root column  ٲ Ƿ goodness  column ߿ C4_SEARCH_ALPHABETA  column .
+*/
+
+static int
+aspiration_root(c4_ctx *ctx, int player, int level, bool report, int *best_goodness)
+{
+	int column, guess, goodness;
+	int alpha = -(INT_MAX), beta = INT_MAX;
+	long long delta = ASPIRATION_WINDOW;
+
+	if (level <= 2)
+		return search_root(ctx, player, level, -1, report, alpha, beta, best_goodness);
+
+	column = search_root(ctx, player, level - 2, -1, false, alpha, beta, &guess);
+	if (ctx->search_aborted) {
+		*best_goodness = guess;
+		return column;
+	}
+	if (guess >= -WIN_SCORE_BOUND && guess <= WIN_SCORE_BOUND) {
+		alpha = (guess - delta < -WIN_SCORE_BOUND) ? -(INT_MAX) : (int)(guess - delta);
+		beta = (guess + delta > WIN_SCORE_BOUND) ? INT_MAX : (int)(guess + delta);
+	}
+
+	for (;;) {
+		column = search_root(ctx, player, level, -1, report, alpha, beta, &goodness);
+		if (ctx->search_aborted)
+			break;
+		if (goodness < alpha) {
+			delta *= 4;
+			alpha = (goodness - delta < -WIN_SCORE_BOUND) ? -(INT_MAX) : (int)(goodness - delta);
+		}
+		else if (goodness > beta) {
+			delta *= 4;
+			beta = (goodness + delta > WIN_SCORE_BOUND) ? INT_MAX : (int)(goodness + delta);
+		}
+		else
+			break;
+	}
+
+	*best_goodness = goodness;
+	return column;
+}
+
+
+
+/**
+* @function run_root_job
+*
+* @param sc Ž   thread Search_context
+* @param job  thread  Žϴ Root_job
+*
+* job  ƹ Ž  column ϳ , ڽ Search_context    evaluate() ŽѴ.
+* ݱ   goodness(best_worst)  thread ϹǷ, ڿ Žϴ column鵵 alpha-beta cutoff ´.
+* goodness  column ߿    column .
+*/
+
+static void
+run_root_job(Search_context *sc, Root_job *job)
+{
+	int i, goodness, maxab;
+	unsigned long nodes;
+	struct timespec start;
+
+	sc->state = *job->root;
+	sc->depth = 0;
+
+	while ((i = atomic_fetch_add(&job->next, 1)) < job->num_columns) {
+		maxab = atomic_load(&job->best_worst);
+		if (maxab < job->alpha)
+			maxab = job->alpha;
+		nodes = sc->nodes;
+		timespec_get(&start, TIME_UTC);
+		drop_piece(sc, job->player, job->columns[i]);
+		goodness = evaluate(sc, job->player, job->level, -job->beta, -maxab);
+		undo_piece(sc);
+		count_root_column(sc, job->columns[i], nodes, &start);
+		if (search_stopped(sc))
+			break;
+
+		/* If this move looks better than the ones previously considered, */
+		/* remember it.                                               	*/
+		mtx_lock(&job->lock);
+		job->goodness[i] = goodness;
+		if (goodness > atomic_load(&job->best_worst) || job->best_index < 0) {
+			atomic_store(&job->best_worst, goodness);
+			job->best_index = i;
+		}
+		if (goodness > job->beta)
+			atomic_store(&job->next, job->num_columns); /*  column Ž ʿ䰡 . */
+		mtx_unlock(&job->lock);
+	}
+}
+
+
+
+/**
+* @function run_lazy_helper
+*
+* @param sc Ž  helper thread Search_context
+* @param job search_contexts[0] Žϰ ִ Root_job
+*
+* Lazy SMP helper thread Ѵ. job root search_contexts[0]   Ž,
+* Ȧ ° helper  ܰ   Žϰ helper column ٸ    ٸ κ Ʈ  ŽѴ.
+*   ʰ transposition table .  ܰ踦 ġ   Žϰ,
+* search_contexts[0]  helpers_stop true Ǹ .
+*/
+
+static void
+run_lazy_helper(Search_context *sc, Root_job *job)
+{
+	c4_ctx *ctx = sc->ctx;
+	int index = (int)(sc - ctx->search_contexts);
+	int level, i, best, goodness, current_column;
+	unsigned long nodes;
+	struct timespec start;
+
+	sc->state = *job->root;
+	sc->depth = 0;
+
+	for (level = job->level + (index % 2); level <= total_size - job->root->num_of_pieces; level++) {
+		best = -(INT_MAX);
+		for (i = 0; i < job->num_columns; i++) {
+			current_column = job->columns[(i + index) % job->num_columns];
+			nodes = sc->nodes;
+			timespec_get(&start, TIME_UTC);
+			drop_piece(sc, job->player, current_column);
+			goodness = evaluate(sc, job->player, level, -(INT_MAX), -best);
+			undo_piece(sc);
+			count_root_column(sc, current_column, nodes, &start);
+			if (search_stopped(sc))
+				return;
+			if (goodness > best)
+				best = goodness;
+		}
+	}
+}
+
+
+
+/**
+* @function stop_workers
+*
+* @param ctx worker thread  c4_ctx
+*
+* c4_ctx_set_threads()  worker thread鿡  ˸,    ٸ.
+*/
+
+static void
+stop_workers(c4_ctx *ctx)
+{
+	int i;
+
+	if (ctx->workers == NULL)
+		return;
+
+	mtx_lock(&ctx->pool_lock);
+	ctx->pool_quit = true;
+	cnd_broadcast(&ctx->pool_wake);
+	mtx_unlock(&ctx->pool_lock);
+	for (i = 0; i<ctx->num_threads - 1; i++)
+		thrd_join(ctx->workers[i], NULL);
+	free(ctx->workers);
+	ctx->workers = NULL;
+}
+
+
+
+/**
+* @function worker_main
+*
+* @param arg  thread  Search_context
+* @return ׻ 0
+*
+* c4_set_threads()  thread ϴ Լ̴.
+* search_root()  Root_job ˷  ٷȴٰ run_root_job()̳ run_lazy_helper() Բ Žϰ,
+* c4_set_threads() ٽ Ҹ .
+*/
+
+static int
+worker_main(void *arg)
+{
+	Search_context *sc = (Search_context *)arg;
+	c4_ctx *ctx = sc->ctx;
+	Root_job *job;
+	int seen_generation = 0;
+
+	mtx_lock(&ctx->pool_lock);
+	for (;;) {
+		while (!ctx->pool_quit && ctx->pool_generation == seen_generation)
+			cnd_wait(&ctx->pool_wake, &ctx->pool_lock);
+		if (ctx->pool_quit)
+			break;
+		seen_generation = ctx->pool_generation;
+		job = ctx->pool_job;
+		mtx_unlock(&ctx->pool_lock);
+
+		sc->helper = job->lazy;
+		if (job->lazy)
+			run_lazy_helper(sc, job);
+		else
+			run_root_job(sc, job);
+
+		mtx_lock(&ctx->pool_lock);
+		if (--ctx->pool_busy == 0)
+			cnd_signal(&ctx->pool_done);
+	}
+	mtx_unlock(&ctx->pool_lock);
+	return 0;
+}
+
+
+
+/**
+* @function evaluate
+*
+* @param sc Ž  Search_context
+* @param player (0) Ǵ ǻ(1)
+* @param level levelŭ  ٺ
+* @param alpha alpha-beta pruning ϱ  
+* @param beta alpha-beta pruning ϱ  
+* @return  ,  ¿ ߻  ִ ־ goodness  
+*
+*  ° Է  player 󸶳   alpha-beta pruning Ͽ levelŭ  ٺ Ѵ.
+*  order_moves()   ŽѴ(principal variation search).
+* ù   window Žϰ,   ù    0 window Ȯ    ٽ ŽѴ.
+* ϰ -beta ̻ -alpha ϶ Ȯ ̰,  ̶   Ѱ谪̴.
+* c4_auto_move_timed() ð  ǰų helper thread  ϸ,  ڷδ Ž ʰ ٷ Ѵ.
+*/
+
+static int
+evaluate(Search_context *sc, int player, int level, int alpha, int beta)
+{
+	c4_ctx *ctx = sc->ctx;
+	Game_state *state = &sc->state;
+
+	sc->nodes++;
+	sc->ply_nodes[sc->depth]++;
+	if (poll_search(sc))
+		return 0; /*    ʴ´. */
+
+	if (state->winner == player)
+		return INT_MAX - sc->depth;
+	else if (state->winner == other(player))
+		return -(INT_MAX - sc->depth);
+	else if (state->num_of_pieces == total_size)
+		return 0; /* a tie */
+	else if (total_size - state->num_of_pieces <= ctx->solver_threshold) {
+		int proven;
+
+		/* ٸ ̳ process ̹ Ǯ  ̶ ٽ Ǯ ʴ´. */
+		if (solved_probe(sc, player, &proven))
+			return proven;
+		return solve_outcome(sc, player);
+	}
+	else if (level == sc->depth)
+		return goodness_of(state, player);
+	else {
+		/* Assume it is the other player's turn. */
+		int best = -(INT_MAX);
+		int best_column = -1, first_column = -1;
+		int maxab = alpha;
+		int remaining = level - sc->depth;
+		bool mirrored;
+		uint64_t key = position_key(state, other(player), &mirrored);
+		Tt_entry entry;
+
+		/*     Ž  ִٸ ״ ϰ, */
+		/* ƴϴ ׶  Ҵ column  ŽѴ.         */
+		/* alpha, beta   Ȯ  ޵ǹǷ Ѱ谪 ׺ ٱ ־   ִ. */
+		if (tt_probe(sc, key, &entry)) {
+			int stored = tt_score(sc, &entry);
+			if (entry.depth >= remaining &&
+				(entry.bound == TT_EXACT ||
+				(entry.bound == TT_LOWER && stored > beta) ||
+				(entry.bound == TT_UPPER && stored < alpha)))
+				return -stored;
+			first_column = entry.best_column;
+			if (mirrored && first_column >= 0)
+				first_column = mirror_column(first_column);
+		}
+
+		int order[WIDTH];
+		int num_moves = order_moves(sc, other(player), first_column, order);
+		sc->interior_nodes++;
+		for (int i = 0; i<num_moves; i++) {
+			int current_column = order[i];
+			int row = drop_piece(sc, other(player), current_column);
+			int goodness;
+			if (i == 0)
+				goodness = evaluate(sc, other(player), level, -beta, -maxab);
+			else {
+				/* ù    0 window Ȯϰ, ٸ  window ٽ ŽѴ. */
+				goodness = evaluate(sc, other(player), level, -maxab, -maxab);
+				if (goodness > maxab && goodness <= beta && !search_stopped(sc))
+					goodness = evaluate(sc, other(player), level, -beta, -maxab);
+			}
+			if (goodness > best) {
+				best = goodness;
+				best_column = current_column;
+				if (best > maxab)
+					maxab = best;
+			}
+			undo_piece(sc);
+			if (search_stopped(sc))
+				return 0;
+			if (best > beta) {
+				sc->cutoffs++;
+				if (i == 0)
+					sc->first_move_cutoffs++;
+				sc->cutoff_index[i]++;
+				record_cutoff(sc, other(player), current_column, row, remaining);
+				break;
+			}
+		}
+
+		tt_store(sc, key, remaining, best, alpha, beta, (mirrored && best_column >= 0) ? mirror_column(best_column) : best_column);
+
+		/* What's good for the other player is bad for this one. */
+		return -best;
+	}
+}
+
+
+
+/**
+* @function poll_search
+*
+* @param sc Ž  Search_context
+* @return Ž  Ѵٸ true
+*
+* 帶 ҸǷ ҿ poll_countdown ̱⸸ ϰ, poll_nodes 帶   poll_clock() ð踦 .
+*/
+
+static bool
+poll_search(Search_context *sc)
+{
+	if (--sc->poll_countdown > 0)
+		return search_stopped(sc);
+	return poll_clock(sc);
+}
+
+
+
+/**
+* @function poll_clock
+*
+* @param sc Ž  Search_context
+* @return Ž  Ѵٸ true
+*
+* c4_poll()  Լ  Ǿٸ ϰ, c4_auto_move_timed() ð  Ǿٸ search_aborted true .
+*  thread Ž  poll Լ search_contexts[0] ϴ thread Ѵ.
+*  ð踦   帥 ð POLL_PERIOD_NS ݺ ª poll_nodes  ,  躸   ٲپ
+*   ӵ   POLL_PERIOD_NS ð踦  Ѵ.
+*/
+
+static bool
+poll_clock(Search_context *sc)
+{
+	c4_ctx *ctx = sc->ctx;
+	int64_t now, elapsed;
+
+	if (ctx->poll_function == NULL && !ctx->deadline_set) {
+		sc->poll_countdown = POLL_MAX_NODES;
+		return search_stopped(sc);
+	}
+
+	now = monotonic_ns();
+	elapsed = now - sc->poll_last;
+	if (elapsed < POLL_PERIOD_NS / 2 && sc->poll_nodes < POLL_MAX_NODES)
+		sc->poll_nodes *= 2;
+	else if (elapsed > POLL_PERIOD_NS * 2 && sc->poll_nodes > POLL_MIN_NODES)
+		sc->poll_nodes /= 2;
+	sc->poll_last = now;
+	sc->poll_countdown = sc->poll_nodes;
+
+	if (ctx->poll_function != NULL && sc == &ctx->search_contexts[0] && ctx->next_poll <= now) {
+		ctx->next_poll += ctx->poll_interval;
+		(*ctx->poll_function)();
+	}
+	if (ctx->deadline_set && ctx->search_deadline <= now)
+		ctx->search_aborted = true;
+	return search_stopped(sc);
+}
+
+
+
+/**
+* @function reset_poll
+*
+* @param ctx Ž  c4_ctx
+*
+* search_root() thread鿡 Ž ñ  θ.  poll Լ θ ð ϰ,
+*  thread ݺ poll_nodes 带 Ž  ð踦  Ѵ. poll_nodes  Ž   ״ .
+*/
+
+static void
+reset_poll(c4_ctx *ctx)
+{
+	int64_t now = monotonic_ns();
+	int i;
+
+	ctx->next_poll = now + ctx->poll_interval;
+	for (i = 0; i < ctx->num_threads; i++) {
+		ctx->search_contexts[i].poll_last = now;
+		ctx->search_contexts[i].poll_countdown = ctx->search_contexts[i].poll_nodes;
+	}
+}
+
+
+
+/**
+* @function monotonic_ns
+*
+* @return   ð 帥 ð(ns). ý ð踦 ٲپ Ųٷ  ʴ´.
+*
+* POSIX CLOCK_MONOTONIC , ٸ C11 timespec_get() .
+*/
+
+static int64_t
+monotonic_ns(void)
+{
+	struct timespec now;
+
+#if defined(CLOCK_MONOTONIC)
+	clock_gettime(CLOCK_MONOTONIC, &now);
+#elif defined(TIME_MONOTONIC)
+	timespec_get(&now, TIME_MONOTONIC);
+#else
+	timespec_get(&now, TIME_UTC);
+#endif
+	return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+
+
+/**
+* @function search_stopped
+*
+* @param sc Ž  Search_context
+* @return Ž  Ѵٸ true
+*
+* ð  Ǿų, sc Lazy SMP helper̰ search_contexts[0] Ž ٸ true̴.
+*  Ž  transposition table  ʴ´.
+*/
+
+static bool
+search_stopped(const Search_context *sc)
+{
+	c4_ctx *ctx = sc->ctx;
+
+	return ctx->search_aborted || (sc->helper && ctx->helpers_stop);
+}
+
+
+
+/**
+* @function reset_node_counts
+*
+* ǻͰ      thread   c4_get_search_stats() ˷ 踦 0 .
+*/
+
+static void
+reset_node_counts(c4_ctx *ctx)
+{
+	int i;
+	Search_context *sc;
+
+	for (i = 0; i<ctx->num_threads; i++) {
+		sc = &ctx->search_contexts[i];
+		sc->nodes = 0;
+		sc->interior_nodes = 0;
+		memset(sc->ply_nodes, 0, sizeof(sc->ply_nodes));
+		memset(sc->cutoff_index, 0, sizeof(sc->cutoff_index));
+		memset(sc->column_nodes, 0, sizeof(sc->column_nodes));
+		memset(sc->column_ms, 0, sizeof(sc->column_ms));
+	}
+}
+
+
+
+/**
+* @function count_root_column
+*
+* @param sc Ž  Search_context
+* @param column  Ž ģ root column
+* @param nodes  column Žϱ  sc->nodes
+* @param start  column Žϱ  ð
+*
+* root column ϳ Žϴ     ð c4_get_search_stats()  Ѵ.
+*/
+
+static void
+count_root_column(Search_context *sc, int column, unsigned long nodes, const struct timespec *start)
+{
+	struct timespec now;
+
+	timespec_get(&now, TIME_UTC);
+	sc->column_nodes[column] += sc->nodes - nodes;
+	sc->column_ms[column] += (now.tv_sec - start->tv_sec) * 1000.0 + (now.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+
+
+/**
+* @function reset_move_ordering
+*
+* ǻͰ      thread killer move  history   δ.
+*    history   ,      ݿǵ Ѵ.
+*/
+
+static void
+reset_move_ordering(c4_ctx *ctx)
+{
+	int i, p, x, y;
+	Search_context *sc;
+
+	for (i = 0; i<ctx->num_threads; i++) {
+		sc = &ctx->search_contexts[i];
+		memset(sc->killers, -1, sizeof(sc->killers));
+		for (p = 0; p < 2; p++)
+			for (x = 0; x < WIDTH; x++)
+				for (y = 0; y < HEIGHT; y++)
+					sc->history[p][x][y] >>= 1;
+	}
+}
+
+
+
+/**
+* @function order_moves
+*
+* @param sc Ž  Search_context
+* @param player     player
+* @param first_column transposition table ˷ column, ٸ -1
+* @param order Ž column   迭
+* @return order  column .   column Ѵ.
+*
+*   ٷ ̱ column, 밡 ٷ ̱ ڸ  column, first_column,
+*   killer move   Žϰ,  history  ū  ŽѴ.
+*  ٸ  column Žϴ drop_order  .
+* 尡 ¿ Ī̶   column ʰ  Ƿ order  ʴ´.
+*/
+
+static int
+order_moves(const Search_context *sc, int player, int first_column, int *order)
+{
+	const Game_state *state = &sc->state;
+	uint64_t own_bits = player_bits(state, player);
+	uint64_t other_bits = player_bits(state, other(player));
+	uint64_t cell;
+	unsigned int rank[WIDTH], key;
+	int i, j, column, row, count = 0;
+	bool symmetric = is_symmetric(state);
+
+	if (symmetric && first_column > mirror_column(first_column))
+		first_column = mirror_column(first_column);
+
+	for (i = 0; i<size_x; i++) {
+		column = drop_order[i];
+		if (state->mask & top_mask(column))
+			continue; /* The column is full. */
+		if (symmetric && column > mirror_column(column))
+			continue; /* Ī 鿡  column  . */
+		cell = (state->mask + bottom_mask(column)) & column_mask(column);
+		row = column_height(state, column);
+
+		if (has_alignment(own_bits | cell))
+			key = ORDER_WIN;
+		else if (has_alignment(other_bits | cell))
+			key = ORDER_BLOCK;
+		else if (column == first_column)
+			key = ORDER_TT;
+		else if (column == sc->killers[sc->depth][0])
+			key = ORDER_KILLER * 2;
+		else if (column == sc->killers[sc->depth][1])
+			key = ORDER_KILLER;
+		else
+			key = sc->history[player][column][row];
+
+		/* rank ū   .  ̸   column տ ´. */
+		for (j = count; j > 0 && rank[j - 1] < key; j--) {
+			rank[j] = rank[j - 1];
+			order[j] = order[j - 1];
+		}
+		rank[j] = key;
+		order[j] = column;
+		count++;
+	}
+	return count;
+}
+
+
+
+/**
+* @function record_cutoff
+*
+* @param sc Ž  Search_context
+* @param player beta cutoff Ų   player
+* @param column   column
+* @param row   row
+* @param remaining  鿡  Ž 
+*
+* column   killer move ϰ,  ̰ Ŭ history   ø.
+* history  HISTORY_MAX   player    ٿ  Ѵ.
+*/
+
+static void
+record_cutoff(Search_context *sc, int player, int column, int row, int remaining)
+{
+	signed char *killers = sc->killers[sc->depth];
+	int x, y;
+
+	if (killers[0] != column) {
+		killers[1] = killers[0];
+		killers[0] = (signed char)column;
+	}
+
+	sc->history[player][column][row] += (unsigned int)(remaining * remaining);
+	if (sc->history[player][column][row] > HISTORY_MAX)
+		for (x = 0; x < WIDTH; x++)
+			for (y = 0; y < HEIGHT; y++)
+				sc->history[player][x][y] >>= 1;
+}
+
+
+
+/**
+* @function solve_outcome
+*
+* @param sc Ž  Search_context
+* @param player (0) Ǵ ǻ(1)
+* @return player 忡  . ̱ INT_MAX - depth,  -(INT_MAX - depth),  0
+*
+*   ĭ solver_threshold   evaluate()  Ѵ.
+*  0 ̿  null window   Ž //и ,
+* ̱ų  쿡   ȿ ٽ Ž     Ȯ Ѵ.
+*     solve()  column Բ solved cache Ѵ.
+*/
+
+static int
+solve_outcome(Search_context *sc, int player)
+{
+	int result;
+
+	/*     window̹Ƿ,  0   ̱. */
+	result = solve(sc, player, 0, 1);
+	if (search_stopped(sc))
+		return 0;
+	if (result < 0)
+		result = solve(sc, player, WIN_SCORE_BOUND, INT_MAX);
+	else {
+		result = solve(sc, player, -1, 0);
+		if (search_stopped(sc))
+			return 0;
+		if (result > 0)
+			result = solve(sc, player, -(INT_MAX), -WIN_SCORE_BOUND);
+		else
+			result = 0; /* a tie */
+	}
+	if (search_stopped(sc))
+		return 0;
+
+	solved_store(sc, player, result, sc->solve_column);
+	return result;
+}
+
+
+
+/**
+* @function solve
+*
+* @param sc Ž  Search_context
+* @param player (0) Ǵ ǻ(1)
+* @param alpha alpha-beta pruning ϱ  
+* @param beta alpha-beta pruning ϱ  
+* @return  ¿    Ž player  
+*
+* evaluate()   ȣ level  ʰ    ŽϹǷ heuristic goodness  ʴ´.
+*    ٷ ̱  ִ column ִٸ  Ž ʴ´.
+*  transposition table   ĭ  ̷ Ͽ ǹǷ,   ٽ Ǯ ʴ´.
+*/
+
+static int
+solve(Search_context *sc, int player, int alpha, int beta)
+{
+	Game_state *state = &sc->state;
+	int best = -(INT_MAX);
+	int best_column = -1, first_column = -1;
+	int maxab = alpha, current_column, searched = 0;
+	int remaining = total_size - state->num_of_pieces;
+	uint64_t key, own_bits;
+	bool mirrored, symmetric;
+	Tt_entry entry;
+
+	sc->nodes++;
+	sc->ply_nodes[sc->depth]++;
+	if (poll_search(sc))
+		return 0; /*    ʴ´. */
+
+	if (state->winner == player)
+		return INT_MAX - sc->depth;
+	else if (state->winner == other(player))
+		return -(INT_MAX - sc->depth);
+	else if (remaining == 0)
+		return 0; /* a tie */
+
+	/*  ٷ ̱  ִٸ װ  ̴ּ. */
+	own_bits = player_bits(state, other(player));
+	for (int i = 0; i<size_x; i++) {
+		current_column = drop_order[i];
+		if (state->mask & top_mask(current_column))
+			continue;
+		if (has_alignment(own_bits | ((state->mask + bottom_mask(current_column)) & column_mask(current_column)))) {
+			sc->solve_column = current_column;
+			return -(INT_MAX - (sc->depth + 1));
+		}
+	}
+
+	key = position_key(state, other(player), &mirrored);
+	if (tt_probe(sc, key, &entry)) {
+		int stored = tt_score(sc, &entry);
+		first_column = entry.best_column;
+		if (mirrored && first_column >= 0)
+			first_column = mirror_column(first_column);
+		if (entry.depth >= remaining &&
+			(entry.bound == TT_EXACT ||
+			(entry.bound == TT_LOWER && stored >= beta) ||
+			(entry.bound == TT_UPPER && stored <= alpha))) {
+			sc->solve_column = first_column;
+			return -stored;
+		}
+	}
+
+	/* Ī 鿡  ݰ  column ŽѴ. */
+	symmetric = is_symmetric(state);
+	if (symmetric && first_column > mirror_column(first_column))
+		first_column = mirror_column(first_column);
+	sc->interior_nodes++;
+
+	for (int i = -1; i<size_x; i++) {
+		current_column = (i < 0) ? first_column : drop_order[i];
+		if (current_column < 0 || (i >= 0 && current_column == first_column))
+			continue;
+		if (state->mask & top_mask(current_column))
+			continue; /* The column is full. */
+		if (symmetric && current_column > mirror_column(current_column))
+			continue;
+		drop_piece(sc, other(player), current_column);
+		int goodness = solve(sc, other(player), -beta, -maxab);
+		if (goodness > best) {
+			best = goodness;
+			best_column = current_column;
+			if (best > maxab)
+				maxab = best;
+		}
+		undo_piece(sc);
+		if (search_stopped(sc))
+			return 0;
+		if (best >= beta) {
+			sc->cutoff_index[searched]++;
+			break;
+		}
+		searched++;
+	}
+
+	tt_store(sc, key, remaining, best, alpha, beta, (mirrored && best_column >= 0) ? mirror_column(best_column) : best_column);
+	sc->solve_column = best_column;
+
+	/* What's good for the other player is bad for this one. */
+	return -best;
+}
+
+
+
+/**
+* @function init_tables
+*
+*   Բ ϴ ǥ . c4_ctx_new_game() call_once() θǷ μ   ȴ.
+* map  ĭ  win place, win_lines  win place ̷ ĭ, drop_order column Ž ̴.
+* ǥ  ũ static 迭̹Ƿ Ӹ ޸𸮸 Ҵϰų  ʴ´.
+* win place  win_lines , map win_linesκ .
+*/
+
+static void
+init_tables(void)
+{
+	register int i, j, k;
+	int win_index, column;
+	int next[WIDTH * HEIGHT];
+
+	win_index = 0;
+
+	/* Fill in the horizontal win positions */
+	for (i = 0; i<size_y; i++) // i = 0~6
+		for (j = 0; j<size_x - num_to_connect + 1; j++) { // j = 0~2
+			for (k = 0; k<num_to_connect; k++) { // k = 0~3
+				win_lines[win_index][k][0] = j + k;
+				win_lines[win_index][k][1] = i;
+			}
+			win_index++;
+		}
+
+	/* Fill in the vertical win positions */
+	for (i = 0; i<size_x; i++)
+		for (j = 0; j<size_y - num_to_connect + 1; j++) {
+			for (k = 0; k<num_to_connect; k++) {
+				win_lines[win_index][k][0] = i;
+				win_lines[win_index][k][1] = j + k;
+			}
+			win_index++;
 		}
 
-		/* If this drop wins the game, take it! */
-		else if (current_state->winner == real_player) {
-			best_column = current_column;
-			pop_state();
-			break;
+	/* Fill in the forward diagonal win positions */
+	for (i = 0; i<size_y - num_to_connect + 1; i++)
+		for (j = 0; j<size_x - num_to_connect + 1; j++) {
+			for (k = 0; k<num_to_connect; k++) {
+				win_lines[win_index][k][0] = j + k;
+				win_lines[win_index][k][1] = i + k;
+			}
+			win_index++;
 		}
 
-		/* Otherwise, look ahead to see how good this move may turn out */
-		/* to be (assuming the opponent makes the best moves possible). */
-		else {
-			next_poll = clock() + poll_interval;
-			goodness = evaluate(real_player, level, -(INT_MAX), -best_worst);
-			printf(" | Current column : %d, goodness : %d\n", current_column + 1, goodness);
+	/* Fill in the backward diagonal win positions */
+	for (i = 0; i<size_y - num_to_connect + 1; i++)
+		for (j = size_x - 1; j >= num_to_connect - 1; j--) {
+			for (k = 0; k<num_to_connect; k++) {
+				win_lines[win_index][k][0] = j - k;
+				win_lines[win_index][k][1] = i + k;
+			}
+			win_index++;
 		}
 
-		/* If this move looks better than the ones previously considered, */
-		/* remember it.                                               	*/
-		if (goodness > best_worst) {
-			best_worst = goodness;
-			best_column = current_column;
-			num_of_equal = 1;
-		}
+	/* map ϱ: ĭ win place   map_offsets  , */
+	/* win place   ĭ  ä.                    */
 
-		pop_state();
+	for (win_index = 0; win_index<win_places; win_index++)
+		for (k = 0; k<num_to_connect; k++)
+			map_offsets[map_cell(win_lines[win_index][k][0], win_lines[win_index][k][1]) + 1]++;
+	for (i = 0; i<total_size; i++) {
+		map_offsets[i + 1] += map_offsets[i];
+		next[i] = map_offsets[i];
 	}
+	for (win_index = 0; win_index<win_places; win_index++)
+		for (k = 0; k<num_to_connect; k++)
+			map_lines[next[map_cell(win_lines[win_index][k][0], win_lines[win_index][k][1])]++] = (uint8_t)win_index;
 
-	move_in_progress = false;
-
-	/* Drop the piece in the column decided upon. */
+	/* Set up the order in which automatic moves should be tried. */
+	/* The columns nearer to the center of the board are usually  */
+	/* better tactically and are more likely to lead to a win.	*/
+	/* By ordering the search such that the central columns are   */
+	/* tried first, alpha-beta cutoff is much more effective. 	*/
 
-	if (best_column >= 0) {
-		result = drop_piece(real_player, best_column);
-		if (column != NULL)
-			*column = best_column;
-		if (row != NULL)
-			*row = result;
-		return true;
+	column = (size_x - 1) / 2;
+	for (i = 1; i <= size_x; i++) {
+		drop_order[i - 1] = column;
+		column += ((i % 2) ? i : -i);
 	}
-	else
-		return false;
-}
-
 
+	/* score_mask Ŀ : CPU ϴ   ɾ  . */
 
-/**
-* @function c4_board
-*
-* @return    ¸ 2 char迭 
-*
-* ϴ 2 迭 column * row , 7*6 2 迭̴.
-*    0, ǻ   1, ƹ     C4_NONE(2) ä ִ.
-*/
+#ifdef HAVE_X86_SIMD
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		score_mask = score_mask_avx2;
+	else if (__builtin_cpu_supports("sse2"))
+		score_mask = score_mask_sse2;
+	else
+#endif
+		score_mask = score_mask_scalar;
 
-char **
-c4_board(void)
-{
-	assert(game_in_progress);
-	return current_state->board;
+	init_zobrist();
 }
 
 
 
 /**
-* @function c4_score_of_player
-*
-* @param player  score ˰  (0) Ǵ ǻ(1)
-* @return player score 
+* @function init_zobrist
 *
-* score ִ   ӵ  ġ(Winning Position) 
-* player  迭 ϼϴµ 󸶳 ߴ   Ҹ Ͽ ġȭ ̴.
+*  player ĭ Zobrist hash  64Ʈ  .
+* rand() ޸ ׻   鵵 seed  splitmix64 ϹǷ,
+*    ,  μ  hash .
 */
 
-int
-c4_score_of_player(int player)
+static void
+init_zobrist(void)
 {
-	assert(game_in_progress);
-	return current_state->score[real_player(player)];
+	uint64_t seed = 0x9E3779B97F4A7C15ULL, z;
+	int player, i;
+
+	for (player = 0; player < 2; player++)
+		for (i = 0; i <= WIDTH * (HEIGHT + 1); i++) {
+			seed += 0x9E3779B97F4A7C15ULL;
+			z = seed;
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+			z ^= z >> 31;
+			if (i < WIDTH * (HEIGHT + 1))
+				zobrist[player][i] = z;
+			else if (player == 1)
+				zobrist_turn = z;
+		}
 }
 
 
 
-
 /**
-* @function c4_is_winner
+* @function is_symmetric
 *
-* @param player ¿θ ˰  (0) Ǵ ǻ(1)
-* @return ߴٸ true, ƴϸ false
-*/
-
-bool
-c4_is_winner(int player)
-{
-	assert(game_in_progress);
-	return (current_state->winner == real_player(player));
-}
-
-
-
-/**
-* @function c4_is_tie
+* @param state Ȯ Game_state
+* @return 尡 ¿ Ī̶ true
 *
-* @return  尡 ϼǾ ºζ true, ƴϸ false
+* Ī 鿡 column c mirror_column(c)   Ƿ ʸ Žϸ ȴ.
+* hash ٸ ٷ false ϰ,   Ʈ带 column Ѵ.
 */
 
-bool
-c4_is_tie(void)
+static bool
+is_symmetric(const Game_state *state)
 {
-	assert(game_in_progress);
-	return (current_state->num_of_pieces == total_size &&
-		current_state->winner == C4_NONE);
-}
+	int column, left, right;
 
+	if (state->hash != state->hash_mirror)
+		return false;
+	for (column = 0; column < WIDTH / 2; column++) {
+		left = column * COLUMN_BITS;
+		right = mirror_column(column) * COLUMN_BITS;
+		if (((state->mask >> left) ^ (state->mask >> right)) & column_mask(0))
+			return false;
+		if (((state->position >> left) ^ (state->position >> right)) & column_mask(0))
+			return false;
+	}
+	return true;
+}
 
 
 
 /**
-* @function c4_win_coords
+* @function position_key
 *
-* @param x1 ϴ ӵ 4    Ʒ   column ǥ
-* @param y1 ϴ ӵ 4    Ʒ   row ǥ
-* @param x2 ϴ ӵ 4       column ǥ
-* @param y2 ϴ ӵ 4       row ǥ
+* @param state key  Game_state
+* @param player  鿡   (0) Ǵ ǻ(1)
+* @param mirrored key ¿  忡 ߴٸ true  
+* @return transposition table   ã  key
 *
-* C   ÿ ϴ  ҰϹǷ,
-*  Լ ִ  ּҸ parameter ޾   column row  
-*  ɾ  ʰ   Ѵ.
+*   ġ  ʰ ٸ ٸ ̹Ƿ hash  ʸ ģ.
+* ¿   goodness Ƿ, hash hash_mirror        ĭ Բ .
+* mirrored true ϰų д column mirror_column()  Ѵ.
 */
 
-void
-c4_win_coords(int *x1, int *y1, int *x2, int *y2)
+static uint64_t
+position_key(const Game_state *state, int player, bool *mirrored)
 {
-	register int i, j, k;
-	int winner, win_pos = 0;
-	bool found;
-
-	assert(game_in_progress);
-
-	winner = current_state->winner;
-	assert(winner != C4_NONE);
-
-	while (current_state->score_array[winner][win_pos] != magic_win_number)
-		win_pos++;
+	uint64_t key;
 
-	/* Find the lower-left piece of the winning connection. */
-
-	found = false;
-	for (j = 0; j<size_y && !found; j++)
-		for (i = 0; i<size_x && !found; i++)
-			for (k = 0; map[i][j][k] != -1; k++)
-				if (map[i][j][k] == win_pos) {
-					*x1 = i;
-					*y1 = j;
-					found = true;
-					break;
-				}
+	*mirrored = state->hash_mirror < state->hash;
+	key = (*mirrored ? state->hash_mirror : state->hash) ^ (player ? zobrist_turn : 0);
 
-	/* Find the upper-right piece of the winning connection. */
-
-	found = false;
-	for (j = size_y - 1; j >= 0 && !found; j--)
-		for (i = size_x - 1; i >= 0 && !found; i--)
-			for (k = 0; map[i][j][k] != -1; k++)
-				if (map[i][j][k] == win_pos) {
-					*x2 = i;
-					*y2 = j;
-					found = true;
-					break;
-				}
+	return key ? key : 1; /* 0  ĭ ϹǷ  ʴ´. */
 }
 
 
 
 /**
-* @function c4_end_game
+* @function tt_probe
 *
-* ǰ ִ  ϰ,  ϸ鼭 Ǿ  ޸𸮸 .
+* @param sc Ž  Search_context. hit/miss/collision Ƚ .
+* @param key position_key()   key
+* @param found ã Tt_entry   
+* @return key شϴ Tt_entry ִٸ true, Ǿ  ʴٸ false
+*
+* ٸ thread  ĭ ġ   Ƿ, ĭ check data   о
+* check ^ data key   data Ǯ found Ѵ.
 */
 
-void
-c4_end_game(void)
+static bool
+tt_probe(Search_context *sc, uint64_t key, Tt_entry *found)
 {
-	int i, j;
-
-	assert(game_in_progress);
-	assert(!move_in_progress);
-
-	/* Free up the memory used by the map. */
+	c4_ctx *ctx = sc->ctx;
+	Tt_slot *slot;
+	uint64_t check, data;
 
-	for (i = 0; i<size_x; i++) {
-		for (j = 0; j<size_y; j++)
-			free(map[i][j]);
-		free(map[i]);
-	}
-	free(map);
-
-	/* Free up the memory of all the states used. */
+	if (ctx->tt_size == 0)
+		return false;
 
-	for (i = 0; i<states_allocated; i++) {
-		for (j = 0; j<size_x; j++)
-			free(state_stack[i].board[j]);
-		free(state_stack[i].board);
-		free(state_stack[i].score_array[0]);
-		free(state_stack[i].score_array[1]);
+	slot = &ctx->tt_table[key & (ctx->tt_size - 1)];
+	data = atomic_load_explicit(&slot->data, memory_order_relaxed);
+	check = atomic_load_explicit(&slot->check, memory_order_relaxed);
+
+	if ((check ^ data) == key) {
+		found->key = key;
+		found->score = (int)(uint32_t)data;
+		found->depth = (signed char)(data >> 32);
+		found->bound = (unsigned char)(data >> 40);
+		found->best_column = (signed char)(data >> 48);
+		sc->tt_hits++;
+		return true;
 	}
-	states_allocated = 0;
-
-	/* Free up the memory used by the drop_order array. */
-
-	free(drop_order);
-
-	game_in_progress = false;
+	if (check == 0 && data == 0)
+		sc->tt_misses++;
+	else
+		sc->tt_collisions++;
+	return false;
 }
 
 
 
-/****************************************************************************/
-/****************************************************************************/
-/**                                                                    	**/
-/**  The following functions are local to this file and should not be  	**/
-/**  called externally.                                                	**/
-/**                                                                    	**/
-/****************************************************************************/
-/****************************************************************************/
-
-
-
 /**
-* @function num_of_win_places
+* @function tt_score
 *
-* @param x ϰ ִ   column 
-* @param y ϰ ִ   row 
-* @param n ӵǰ ؾ ϴ  
-* @return ش  忡    ӵ  (Winning Position) 
+* @param sc Ž  Search_context
+* @param entry tt_probe() ã Tt_entry
+* @return  score  depth  ٲ 
+*
+* а  score  κ Ÿ Ǿ Ƿ, rootκ ̸ ٽ Ѵ.
 */
 
 static int
-num_of_win_places(int x, int y, int n) // num_of_win_places(6, 7, 4)
+tt_score(const Search_context *sc, const Tt_entry *entry)
 {
-	if (x < n && y < n)
-		return 0;
-	else if (x < n)
-		return x * ((y - n) + 1);
-	else if (y < n)
-		return y * ((x - n) + 1);
-	else // ׻ . return 69.
-		return 4 * x*y - 3 * x*n - 3 * y*n + 3 * x + 3 * y - 4 * n + 2 * n*n + 2;
+	if (entry->score > WIN_SCORE_BOUND)
+		return entry->score - sc->depth;
+	else if (entry->score < -WIN_SCORE_BOUND)
+		return entry->score + sc->depth;
+	return entry->score;
 }
 
 
 
 /**
-* @function update_score
+* @function tt_store
 *
-* @param player  score  Ʈϰ  (0) Ǵ ǻ(1)
-* @param x Է  ּ 
-* @param y Է  ִ 
+* @param sc Ž  Search_context
+* @param key position_key()   key
+* @param remaining score   Ž  
+* @param score   player 忡 score
+* @param alpha Ž   alpha 
+* @param beta Ž   beta 
+* @param best_column  Ҵ column
 *
-*  ¿ player column x, row y ڸ   ,  score  ƮѴ.
+* Ž  transposition table Ѵ.  ĭ ̹ ٸ  ִٸ   .
+* а  score rootκ ̸   κ Ÿ Ѵ.
 */
 
 static void
-update_score(int player, int x, int y)
+tt_store(const Search_context *sc, uint64_t key, int remaining, int score, int alpha, int beta, int best_column)
 {
-	register int i;
-	int win_index;
-	int this_difference = 0, other_difference = 0;
-	int **current_score_array = current_state->score_array;
-	int other_player = other(player);
+	c4_ctx *ctx = sc->ctx;
+	Tt_slot *slot;
+	uint64_t check, data;
+	int bound;
 
-	for (i = 0; map[x][y][i] != -1; i++) {
-		win_index = map[x][y][i];
-		this_difference += current_score_array[player][win_index];
-		other_difference += current_score_array[other_player][win_index];
-
-		current_score_array[player][win_index] <<= 1;
-		current_score_array[other_player][win_index] = 0;
+	if (ctx->tt_size == 0)
+		return;
 
-		if (current_score_array[player][win_index] == magic_win_number)
-			if (current_state->winner == C4_NONE)
-				current_state->winner = player;
-	}
+	slot = &ctx->tt_table[key & (ctx->tt_size - 1)];
+	data = atomic_load_explicit(&slot->data, memory_order_relaxed);
+	check = atomic_load_explicit(&slot->check, memory_order_relaxed);
+	if ((check ^ data) == key && (signed char)(data >> 32) > remaining)
+		return; /*   Ž   д. */
 
-	current_state->score[player] += this_difference;
-	current_state->score[other_player] -= other_difference;
+	if (score >= beta)
+		bound = TT_LOWER;
+	else if (score <= alpha)
+		bound = TT_UPPER;
+	else
+		bound = TT_EXACT;
+
+	if (score > WIN_SCORE_BOUND)
+		score += sc->depth;
+	else if (score < -WIN_SCORE_BOUND)
+		score -= sc->depth;
+
+	data = (uint64_t)(uint32_t)score |
+		(uint64_t)(unsigned char)remaining << 32 |
+		(uint64_t)bound << 40 |
+		(uint64_t)(unsigned char)best_column << 48;
+	atomic_store_explicit(&slot->data, data, memory_order_relaxed);
+	atomic_store_explicit(&slot->check, key ^ data, memory_order_relaxed);
 }
 
 
 
 /**
-* @function drop_piece
+* @function solved_probe
 *
-* @param player (0) Ǵ ǻ(1)
-* @param column   column 
-* @return   Ҵٸ,   ǥ row  
-*		      ߴٸ, -1 Ѵ.
+* @param sc Ž  Search_context
+* @param player (0) Ǵ ǻ(1). evaluate()    ̴.
+* @param score ã  player  evaluate()   
+* @return   solved cache ִٸ true
 *
-* Է¹ player  Է¹ columnٰ  Լ̴.
+* key  ĭ SOLVED_PROBES ĭ ʷ ,  ĭ    .
 */
 
-static int
-drop_piece(int player, int column)
+static bool
+solved_probe(Search_context *sc, int player, int *score)
 {
-	int y = 0;
-
-	while (current_state->board[column][y] != C4_NONE && ++y < size_y)
-		;
+	c4_ctx *ctx = sc->ctx;
+	Tt_slot *slot;
+	uint64_t key, check, data;
+	bool mirrored;
+	int stored;
 
-	if (y == size_y)
-		return -1;
+	if (ctx->solved_size == 0)
+		return false;
 
-	current_state->board[column][y] = player;
-	current_state->num_of_pieces++;
-	update_score(player, column, y);
+	key = position_key(&sc->state, other(player), &mirrored);
+	for (int i = 0; i<SOLVED_PROBES; i++) {
+		slot = &ctx->solved_table[(key + i) & (ctx->solved_size - 1)];
+		data = atomic_load_explicit(&slot->data, memory_order_relaxed);
+		check = atomic_load_explicit(&slot->check, memory_order_relaxed);
+		if (check == 0 && data == 0)
+			return false;
+		if ((check ^ data) != key)
+			continue;
 
-	return y;
+		stored = (int)(uint32_t)data;
+		if (stored > WIN_SCORE_BOUND)
+			stored -= sc->depth;
+		else if (stored < -WIN_SCORE_BOUND)
+			stored += sc->depth;
+		*score = -stored;
+		return true;
+	}
+	return false;
 }
 
 
 
 /**
-* @function push_state
+* @function solved_store
+*
+* @param sc Ž  Search_context
+* @param player (0) Ǵ ǻ(1). evaluate()    ̴.
+* @param score solve_outcome()  player  
+* @param best_column    best column, ٸ -1
 *
-* Game_state ȿ    ִ   ׽Ʈ  ֵ ο Game_state  stack ־ִ Լ̴.
-* MinMax ˰  , stack  Game_state push, popϸ鼭    ǥ Ѵ.
+*   solved cache  ĭ̳   ĭ .
+* ãƺ ĭ  ٸ   ִٸ key   ĭ .
+* score tt_store()ó  κ Ÿ, best_column key     Ѵ.
 */
 
 static void
-push_state(void)
+solved_store(const Search_context *sc, int player, int score, int best_column)
 {
-	register int i, win_places_array_size;
-	Game_state *old_state, *new_state;
+	c4_ctx *ctx = sc->ctx;
+	Tt_slot *slot = NULL;
+	uint64_t key, check, data;
+	bool mirrored;
 
-	win_places_array_size = win_places * sizeof(int);
-	old_state = &state_stack[depth++];
-	new_state = &state_stack[depth];
-
-	if (depth == states_allocated) {
+	if (ctx->solved_size == 0)
+		return;
 
-		/* Allocate space for the board */
+	key = position_key(&sc->state, other(player), &mirrored);
+	for (int i = 0; i<SOLVED_PROBES; i++) {
+		slot = &ctx->solved_table[(key + i) & (ctx->solved_size - 1)];
+		data = atomic_load_explicit(&slot->data, memory_order_relaxed);
+		check = atomic_load_explicit(&slot->check, memory_order_relaxed);
+		if ((check == 0 && data == 0) || (check ^ data) == key)
+			break;
+		if (i == SOLVED_PROBES - 1)
+			slot = &ctx->solved_table[key & (ctx->solved_size - 1)];
+	}
 
-		new_state->board = (char **)emalloc(size_x * sizeof(char *));
-		for (i = 0; i<size_x; i++)
-			new_state->board[i] = (char *)emalloc(size_y);
+	/*   score ٲ۴. */
+	score = -score;
+	if (score > WIN_SCORE_BOUND)
+		score += sc->depth;
+	else if (score < -WIN_SCORE_BOUND)
+		score -= sc->depth;
+	if (mirrored && best_column >= 0)
+		best_column = mirror_column(best_column);
+
+	data = (uint64_t)(uint32_t)score |
+		(uint64_t)(unsigned char)best_column << 32 |
+		SOLVED_USED;
+	atomic_store_explicit(&slot->data, data, memory_order_relaxed);
+	atomic_store_explicit(&slot->check, key ^ data, memory_order_relaxed);
+}
 
-		/* Allocate space for the score array */
 
-		new_state->score_array[0] = (int *)emalloc(win_places_array_size);
-		new_state->score_array[1] = (int *)emalloc(win_places_array_size);
 
-		states_allocated++;
-	}
+/**
+* @function trace_event
+*
+* c4_set_trace()  Լ ִٸ event Ѱش.
+*/
 
-	/* Copy the board */
+static void
+trace_event(const c4_ctx *ctx, c4_trace_event *event)
+{
+	if (ctx->trace_function != NULL)
+		ctx->trace_function(event, ctx->trace_data);
+}
 
-	for (i = 0; i<size_x; i++)
-		memcpy(new_state->board[i], old_state->board[i], size_y);
 
-	/* Copy the score array */
 
-	memcpy(new_state->score_array[0], old_state->score_array[0],
-		win_places_array_size);
-	memcpy(new_state->score_array[1], old_state->score_array[1],
-		win_places_array_size);
+/**
+* @function trace_rule
+*
+* @param rule Ǵ rule ȣ. 0 default rule̴.
+* @param verdict C4_RULE_CHECKED, C4_RULE_USED Ǵ C4_RULE_REJECTED
+*
+* c4_rule_auto_move()  rule Ȯϰ ߴ C4_TRACE_RULE event ˸.
+*/
 
-	new_state->score[0] = old_state->score[0];
-	new_state->score[1] = old_state->score[1];
-	new_state->winner = old_state->winner;
-	new_state->num_of_pieces = old_state->num_of_pieces;
+static void
+trace_rule(const c4_ctx *ctx, int rule, int verdict)
+{
+	c4_trace_event event = { .kind = C4_TRACE_RULE };
 
-	current_state = new_state;
+	event.rule = rule;
+	event.verdict = verdict;
+	trace_event(ctx, &event);
 }
 
 
 
 /**
-* @function evaluate
+* @function default_context
 *
-* @param player (0) Ǵ ǻ(1)
-* @param level levelŭ  ٺ
-* @param alpha alpha-beta pruning ϱ  
-* @param beta alpha-beta pruning ϱ  
-* @return  ,  ¿ ߻  ִ ־ goodness  
+* @return c4_ ϴ  Լ ϴ c4_ctx
 *
-*  ° Է  player 󸶳   alpha-beta pruning Ͽ levelŭ  ٺ Ѵ.
+* ó θ  default_ctx .  Լ  thread Ѵٰ Ѵ.
 */
 
-static int
-evaluate(int player, int level, int alpha, int beta)
+static c4_ctx *
+default_context(void)
 {
-	if (poll_function != NULL && next_poll <= clock()) {
-		next_poll += poll_interval;
-		(*poll_function)();
-	}
-
-	if (current_state->winner == player)
-		return INT_MAX - depth;
-	else if (current_state->winner == other(player))
-		return -(INT_MAX - depth);
-	else if (current_state->num_of_pieces == total_size)
-		return 0; /* a tie */
-	else if (level == depth)
-		return goodness_of(player);
-	else {
-		/* Assume it is the other player's turn. */
-		int best = -(INT_MAX);
-		int maxab = alpha;
-		int Hdrop_order[7];
-		heuristicDropOrder(other(player), Hdrop_order);
-		for (int i = 0; i<size_x; i++) {
-			if (current_state->board[drop_order[i]][size_y - 1] != C4_NONE)
-				continue; /* The column is full. */
-			push_state();
-			drop_piece(other(player), drop_order[i]);
-			int goodness = evaluate(other(player), level, -beta, -maxab);
-			if (goodness > best) {
-				best = goodness;
-				if (best > maxab)
-					maxab = best;
-			}
-			pop_state();
-			if (best > beta)
-				break;
-		}
-
-		/* What's good for the other player is bad for this one. */
-		return -best;
-	}
+	if (default_ctx == NULL)
+		default_ctx = c4_ctx_new();
+	return default_ctx;
 }
 
 
@@ -960,7 +4325,7 @@ emalloc(size_t size)
 */
 
 int
-rule1_1(int player) {
+rule1_1(c4_ctx *ctx, int player) {
 
 	int winLineArr[70]; // score  8 
 	int i, j, x, y, z;
@@ -973,20 +4338,20 @@ rule1_1(int player) {
 		winLineArr[i] = -1;
 	}
 
-	r12_winning8check(player, winLineArr);
+	r12_winning8check(ctx, player, winLineArr);
 
 	for (i = 0; winLineArr[i] != -1; i++) {
 		if (winLineArr[i] < 24) {
 			x = winLineArr[i] % 4;
 			y = winLineArr[i] / 4;
 			for (j = 0; j < 4; j++) {
-				if (current_state->board[x + j][y] == C4_NONE) {
+				if (board_cell(ctx, x + j, y) == C4_NONE) {
 					jx = x + j; iy = y;
 					if (iy == 0) {
 						exists = true;
 						break;
 					}
-					else if (current_state->board[jx][iy - 1] != C4_NONE) {
+					else if (board_cell(ctx, jx, iy - 1) != C4_NONE) {
 						exists = true;
 						break;
 					}
@@ -999,14 +4364,14 @@ rule1_1(int player) {
 			x = z / 3;
 			y = z % 3;
 			for (j = 0; j < 4; j++) {
-				if (current_state->board[x][y + j] == C4_NONE) {
+				if (board_cell(ctx, x, y + j) == C4_NONE) {
 					jx = x; iy = y + j;
 					if (iy == 0) {
 						exists = true;
 						break;
 					}
 
-					else if (current_state->board[jx][iy - 1] != C4_NONE) {
+					else if (board_cell(ctx, jx, iy - 1) != C4_NONE) {
 						exists = true;
 						break;
 					}
@@ -1019,13 +4384,13 @@ rule1_1(int player) {
 			x = z % 4;
 			y = z / 4;
 			for (j = 0; j < 4; j++) {
-				if (current_state->board[x + j][y + j] == C4_NONE) {
+				if (board_cell(ctx, x + j, y + j) == C4_NONE) {
 					jx = x + j; iy = y + j;
 					if (iy == 0) {
 						exists = true;
 						break;
 					}
-					else if (current_state->board[jx][iy - 1] != C4_NONE) {
+					else if (board_cell(ctx, jx, iy - 1) != C4_NONE) {
 						exists = true;
 						break;
 					}
@@ -1038,14 +4403,14 @@ rule1_1(int player) {
 			x = 6 - (z % 4);
 			y = z / 4;
 			for (j = 0; j < 4; j++) {
-				if (current_state->board[x - j][y + j] == C4_NONE) {
+				if (board_cell(ctx, x - j, y + j) == C4_NONE) {
 					jx = x - j; iy = y + j;
 
 					if (iy == 0) {
 						exists = true;
 						break;
 					}
-					else if (current_state->board[jx][iy - 1] != C4_NONE) {
+					else if (board_cell(ctx, jx, iy - 1) != C4_NONE) {
 						exists = true;
 						break;
 					}
@@ -1083,15 +4448,15 @@ rule1_1(int player) {
 */
 
 void
-r12_winning8check(int player, int* winLineArr) { // x is array of possible winning lines
+r12_winning8check(c4_ctx *ctx, int player, int* winLineArr) { // x is array of possible winning lines
 	int i;
 	int count = 0;
+	uint32_t threes[SCORE_MASK_WORDS];
 
-	for (i = 0; i < 69; i++) {
-		if (current_state->score_array[player][i] == 8) {
-			winLineArr[count] = i;
-			count++;
-		}
+	score_mask(ctx->current_state->score_array[player], 8, threes);
+	for (i = next_line(threes, 0); i >= 0; i = next_line(threes, i + 1)) {
+		winLineArr[count] = i;
+		count++;
 	}
 
 }
@@ -1112,7 +4477,7 @@ r12_winning8check(int player, int* winLineArr) { // x is array of possible winni
 
 
 int
-rule2_1(int player) {
+rule2_1(c4_ctx *ctx, int player) {
 
 	player = other(player);
 	int winLineArr[70];
@@ -1126,20 +4491,20 @@ rule2_1(int player) {
 		winLineArr[i] = -1;
 	}
 
-	r12_winning8check(player, winLineArr);
+	r12_winning8check(ctx, player, winLineArr);
 
 	for (i = 0; winLineArr[i] != -1; i++) {
 		if (winLineArr[i] < 24) {
 			x = winLineArr[i] % 4;
 			y = winLineArr[i] / 4;
 			for (j = 0; j < 4; j++) {
-				if (current_state->board[x + j][y] == C4_NONE) {
+				if (board_cell(ctx, x + j, y) == C4_NONE) {
 					jx = x + j; iy = y;
 					if (iy == 0) {
 						exists = true;
 						break;
 					}
-					else if (current_state->board[jx][iy - 1] != C4_NONE) {
+					else if (board_cell(ctx, jx, iy - 1) != C4_NONE) {
 						exists = true;
 						break;
 					}
@@ -1152,13 +4517,13 @@ rule2_1(int player) {
 			x = z / 3;
 			y = z % 3;
 			for (j = 0; j < 4; j++) {
-				if (current_state->board[x][y + j] == C4_NONE) {
+				if (board_cell(ctx, x, y + j) == C4_NONE) {
 					jx = x; iy = y + j;
 					if (iy == 0) {
 						exists = true;
 						break;
 					}
-					else if (current_state->board[jx][iy - 1] != C4_NONE) {
+					else if (board_cell(ctx, jx, iy - 1) != C4_NONE) {
 						exists = true;
 						break;
 					}
@@ -1172,14 +4537,14 @@ rule2_1(int player) {
 			x = z % 4;
 			y = z / 4;
 			for (j = 0; j < 4; j++) {
-				if (current_state->board[x + j][y + j] == C4_NONE) {
+				if (board_cell(ctx, x + j, y + j) == C4_NONE) {
 					jx = x + j; iy = y + j;
 
 					if (iy == 0) {
 						exists = true;
 						break;
 					}
-					else if (current_state->board[jx][iy - 1] != C4_NONE) {
+					else if (board_cell(ctx, jx, iy - 1) != C4_NONE) {
 						exists = true;
 						break;
 					}
@@ -1192,14 +4557,14 @@ rule2_1(int player) {
 			x = 6 - (z % 4);
 			y = z / 4;
 			for (j = 0; j < 4; j++) {
-				if (current_state->board[x - j][y + j] == C4_NONE) {
+				if (board_cell(ctx, x - j, y + j) == C4_NONE) {
 					jx = x - j; iy = y + j;
 
 					if (iy == 0) {
 						exists = true;
 						break;
 					}
-					else if (current_state->board[jx][iy - 1] != C4_NONE) {
+					else if (board_cell(ctx, jx, iy - 1) != C4_NONE) {
 						exists = true;
 						break;
 					}
@@ -1237,21 +4602,21 @@ rule2_1(int player) {
 */
 
 int
-rule3(int player) {
+rule3(c4_ctx *ctx, int player) {
 	int sel;
 	//printf("< RULE 3 >\n");
 	for (int i = 0; i < 7; i++) {
 		for (int j = 0; j < 6; j++) {
-			if ((int)current_state->board[i][j] == 2) {
-				sel = r34_horizontalCheck(other(player), i, j);
+			if ((int)board_cell(ctx, i, j) == 2) {
+				sel = r34_horizontalCheck(ctx, other(player), i, j);
 				if (sel != -1) { // horizontalCheck return   ϴ col
 					return sel;
 				}
-				sel = r34_diagonalCheckPos(other(player), i, j);
+				sel = r34_diagonalCheckPos(ctx, other(player), i, j);
 				if (sel != -1) {
 					return sel;
 				}
-				sel = r34_diagonalCheckNeg(other(player), i, j);
+				sel = r34_diagonalCheckNeg(ctx, other(player), i, j);
 				if (sel != -1) {
 					return sel;
 				}
@@ -1278,21 +4643,21 @@ rule3(int player) {
 */
 
 int
-rule4(int player) {
+rule4(c4_ctx *ctx, int player) {
 	int sel;
 	//printf("< RULE 4 >\n");
 	for (int i = 0; i < 7; i++) {
 		for (int j = 0; j < 6; j++) {
-			if ((int)current_state->board[i][j] == 2) {
-				sel = r34_horizontalCheck(player, i, j);
+			if ((int)board_cell(ctx, i, j) == 2) {
+				sel = r34_horizontalCheck(ctx, player, i, j);
 				if (sel != -1) { // horizontalCheck return   ϴ col
 					return sel;
 				}
-				sel = r34_diagonalCheckPos(player, i, j);
+				sel = r34_diagonalCheckPos(ctx, player, i, j);
 				if (sel != -1) {
 					return sel;
 				}
-				sel = r34_diagonalCheckNeg(player, i, j);
+				sel = r34_diagonalCheckNeg(ctx, player, i, j);
 				if (sel != -1) {
 					return sel;
 				}
@@ -1322,16 +4687,16 @@ rule4(int player) {
 */
 
 int
-r34_diagonalCheckPos(int player, int col, int row) {
+r34_diagonalCheckPos(c4_ctx *ctx, int player, int col, int row) {
 	if (col >= 3) return -1;
 	//printf("Diagonal Check Pos is called\n");
-	if ((int)current_state->board[col + 1][row + 1] == 2) {
-		if ((current_state->board[col + 2][row + 2] == player)
-			&& (current_state->board[col + 3][row + 3] == player)
-			&& ((int)current_state->board[col + 4][row + 4] == 2)
-			&& ((int)current_state->board[col + 1][row] != 2)
-			&& ((int)current_state->board[col + 4][row + 3] != 2)) {
-			if ((row > 0 && (int)current_state->board[col][row - 1] != 2) || (row == 0)) {
+	if ((int)board_cell(ctx, col + 1, row + 1) == 2) {
+		if ((board_cell(ctx, col + 2, row + 2) == player)
+			&& (board_cell(ctx, col + 3, row + 3) == player)
+			&& ((int)board_cell(ctx, col + 4, row + 4) == 2)
+			&& ((int)board_cell(ctx, col + 1, row) != 2)
+			&& ((int)board_cell(ctx, col + 4, row + 3) != 2)) {
+			if ((row > 0 && (int)board_cell(ctx, col, row - 1) != 2) || (row == 0)) {
 				//printf("Diagonal Check Pos case 1\n");
 				return col + 1;
 			}
@@ -1339,23 +4704,23 @@ r34_diagonalCheckPos(int player, int col, int row) {
 		//printf("here1\n");
 		return -1;
 	}
-	else if (current_state->board[col + 1][row + 1] == player) {
-		if ((current_state->board[col + 2][row + 2] == player)
-			&& ((int)current_state->board[col + 3][row + 3] == 2)
-			&& ((int)current_state->board[col + 4][row + 4] == 2)
-			&& ((int)current_state->board[col + 3][row + 2] != 2)
-			&& ((int)current_state->board[col + 4][row + 3] != 2)) {
-			if ((row > 0 && (int)current_state->board[col][row - 1] != 2) || (row == 0)) {
+	else if (board_cell(ctx, col + 1, row + 1) == player) {
+		if ((board_cell(ctx, col + 2, row + 2) == player)
+			&& ((int)board_cell(ctx, col + 3, row + 3) == 2)
+			&& ((int)board_cell(ctx, col + 4, row + 4) == 2)
+			&& ((int)board_cell(ctx, col + 3, row + 2) != 2)
+			&& ((int)board_cell(ctx, col + 4, row + 3) != 2)) {
+			if ((row > 0 && (int)board_cell(ctx, col, row - 1) != 2) || (row == 0)) {
 				//printf("Diagonal Check Pos case 2\n");
 				return col + 3;
 			}
 		}
-		if ((int)(current_state->board[col + 2][row + 2] == 2)
-			&& (current_state->board[col + 3][row + 3] == player)
-			&& ((int)current_state->board[col + 4][row + 4] == 2)
-			&& ((int)current_state->board[col + 2][row + 1] != 2)
-			&& ((int)current_state->board[col + 4][row + 3] != 2)) {
-			if ((row > 0 && (int)current_state->board[col][row - 1] != 2) || (row == 0)) {
+		if ((int)(board_cell(ctx, col + 2, row + 2) == 2)
+			&& (board_cell(ctx, col + 3, row + 3) == player)
+			&& ((int)board_cell(ctx, col + 4, row + 4) == 2)
+			&& ((int)board_cell(ctx, col + 2, row + 1) != 2)
+			&& ((int)board_cell(ctx, col + 4, row + 3) != 2)) {
+			if ((row > 0 && (int)board_cell(ctx, col, row - 1) != 2) || (row == 0)) {
 				//printf("Diagonal Check Pos case 3\n");
 				return col + 2;
 			}
@@ -1387,39 +4752,39 @@ r34_diagonalCheckPos(int player, int col, int row) {
 */
 
 int
-r34_diagonalCheckNeg(int player, int col, int row) {
+r34_diagonalCheckNeg(c4_ctx *ctx, int player, int col, int row) {
 	if (col < 5) return -1;
 	//printf("Diagonal Check Neg is called\n");
-	if ((int)current_state->board[col - 1][row + 1] == 2) {
-		if ((current_state->board[col - 2][row + 2] == player)
-			&& (current_state->board[col - 3][row + 3] == player)
-			&& ((int)current_state->board[col - 4][row + 4] == 2)
-			&& ((int)current_state->board[col - 1][row] != 2)
-			&& ((int)current_state->board[col - 4][row + 3] != 2)) {
-			if ((row > 0 && (int)current_state->board[col][row - 1] != 2) || (row == 0)) {
+	if ((int)board_cell(ctx, col - 1, row + 1) == 2) {
+		if ((board_cell(ctx, col - 2, row + 2) == player)
+			&& (board_cell(ctx, col - 3, row + 3) == player)
+			&& ((int)board_cell(ctx, col - 4, row + 4) == 2)
+			&& ((int)board_cell(ctx, col - 1, row) != 2)
+			&& ((int)board_cell(ctx, col - 4, row + 3) != 2)) {
+			if ((row > 0 && (int)board_cell(ctx, col, row - 1) != 2) || (row == 0)) {
 				//printf("Diagonal Check Neg case 1\n");
 				return col - 1;
 			}
 		}
 		return -1;
 	}
-	else if (current_state->board[col - 1][row + 1] == player) {
-		if ((current_state->board[col - 2][row + 2] == player)
-			&& ((int)current_state->board[col - 3][row + 3] == 2)
-			&& ((int)current_state->board[col - 4][row + 4] == 2)
-			&& ((int)current_state->board[col - 3][row + 2] != 2)
-			&& ((int)current_state->board[col - 4][row + 3] != 2)) {
-			if ((row > 0 && (int)current_state->board[col][row - 1] != 2) || (row == 0)) {
+	else if (board_cell(ctx, col - 1, row + 1) == player) {
+		if ((board_cell(ctx, col - 2, row + 2) == player)
+			&& ((int)board_cell(ctx, col - 3, row + 3) == 2)
+			&& ((int)board_cell(ctx, col - 4, row + 4) == 2)
+			&& ((int)board_cell(ctx, col - 3, row + 2) != 2)
+			&& ((int)board_cell(ctx, col - 4, row + 3) != 2)) {
+			if ((row > 0 && (int)board_cell(ctx, col, row - 1) != 2) || (row == 0)) {
 				//printf("Diagonal Check Neg case 2\n");
 				return col - 3;
 			}
 		}
-		if ((int)(current_state->board[col - 2][row + 2] == 2)
-			&& (current_state->board[col - 3][row + 3] == player)
-			&& ((int)current_state->board[col - 4][row + 4] == 2)
-			&& ((int)current_state->board[col - 2][row + 1] != 2)
-			&& ((int)current_state->board[col - 4][row + 3] != 2)) {
-			if ((row > 0 && (int)current_state->board[col][row - 1] != 2) || (row == 0)) {
+		if ((int)(board_cell(ctx, col - 2, row + 2) == 2)
+			&& (board_cell(ctx, col - 3, row + 3) == player)
+			&& ((int)board_cell(ctx, col - 4, row + 4) == 2)
+			&& ((int)board_cell(ctx, col - 2, row + 1) != 2)
+			&& ((int)board_cell(ctx, col - 4, row + 3) != 2)) {
+			if ((row > 0 && (int)board_cell(ctx, col, row - 1) != 2) || (row == 0)) {
 				//printf("Diagonal Check Neg case 3\n");
 				return col - 2;
 			}
@@ -1445,38 +4810,38 @@ r34_diagonalCheckNeg(int player, int col, int row) {
 */
 
 int
-r34_horizontalCheck(int player, int col, int row) {
+r34_horizontalCheck(c4_ctx *ctx, int player, int col, int row) {
 	if (col >= 3) return -1;
 	//printf("Horizontal Check is called\n");
-	if ((int)current_state->board[col + 1][row] == 2) { // __oo_ ̸鼭  ĭ Ʒ  𰡷 ä ִ 츸 Ѵ.
+	if ((int)board_cell(ctx, col + 1, row) == 2) { // __oo_ ̸鼭  ĭ Ʒ  𰡷 ä ִ 츸 Ѵ.
 														//printf("check __oo_ \n");
-		if ((current_state->board[col + 2][row] == player)
-			&& (current_state->board[col + 3][row] == player)
-			&& ((int)current_state->board[col + 4][row] == 2)
-			&& ((int)current_state->board[col + 1][row - 1] != 2)
-			&& ((int)current_state->board[col][row - 1] != 2)
-			&& ((int)current_state->board[col + 4][row - 1] != 2)) {
+		if ((board_cell(ctx, col + 2, row) == player)
+			&& (board_cell(ctx, col + 3, row) == player)
+			&& ((int)board_cell(ctx, col + 4, row) == 2)
+			&& ((int)board_cell(ctx, col + 1, row - 1) != 2)
+			&& ((int)board_cell(ctx, col, row - 1) != 2)
+			&& ((int)board_cell(ctx, col + 4, row - 1) != 2)) {
 			//printf("Horizontal Check case 1\n");
 			return col + 1;
 		}
 	}
-	if (current_state->board[col + 1][row] == player) { // _oo__, _o_o_
+	if (board_cell(ctx, col + 1, row) == player) { // _oo__, _o_o_
 														//printf("check _oo__ and _o_o_ \n;");
-		if ((current_state->board[col + 2][row] == player) // _oo__
-			&& ((int)current_state->board[col + 3][row] == 2)
-			&& ((int)current_state->board[col + 4][row] == 2)
-			&& ((int)current_state->board[col + 3][row - 1] != 2)
-			&& ((int)current_state->board[col + 4][row - 1] != 2)
-			&& ((int)current_state->board[col][row - 1] != 2)) {
+		if ((board_cell(ctx, col + 2, row) == player) // _oo__
+			&& ((int)board_cell(ctx, col + 3, row) == 2)
+			&& ((int)board_cell(ctx, col + 4, row) == 2)
+			&& ((int)board_cell(ctx, col + 3, row - 1) != 2)
+			&& ((int)board_cell(ctx, col + 4, row - 1) != 2)
+			&& ((int)board_cell(ctx, col, row - 1) != 2)) {
 			//printf("Horizontal Check case 2\n");
 			return col + 3;
 		}
-		if (((int)current_state->board[col + 2][row] == 2) // _o_o_
-			&& (current_state->board[col + 3][row] == player)
-			&& ((int)current_state->board[col + 4][row] == 2)
-			&& ((int)current_state->board[col + 2][row - 1] != 2)
-			&& ((int)current_state->board[col][row - 1] != 2)
-			&& ((int)current_state->board[col + 4][row - 1] != 2)) {
+		if (((int)board_cell(ctx, col + 2, row) == 2) // _o_o_
+			&& (board_cell(ctx, col + 3, row) == player)
+			&& ((int)board_cell(ctx, col + 4, row) == 2)
+			&& ((int)board_cell(ctx, col + 2, row - 1) != 2)
+			&& ((int)board_cell(ctx, col, row - 1) != 2)
+			&& ((int)board_cell(ctx, col + 4, row - 1) != 2)) {
 			//printf("Horizontal Check case 3\n");
 			return col + 2;
 		}
@@ -1501,31 +4866,39 @@ r34_horizontalCheck(int player, int col, int row) {
 */
 
 int
-rule5(int player, int *colArr, int min) {   //rule5
-	int win_index, i, x, y, k = 0, z;
-	int **current_score_array = current_state->score_array;
+rule5(c4_ctx *ctx, int player, int *colArr, int min) {   //rule5
+	int win_index, i, x, y, k, z;
+	bool found;
+	int8_t (*current_score_array)[SCORE_STRIDE] = ctx->current_state->score_array;
+	uint32_t mine[SCORE_MASK_WORDS], theirs[SCORE_MASK_WORDS], either[SCORE_MASK_WORDS];
+
+	score_mask(current_score_array[player], 4, mine);  //  2  winning row
+	score_mask(current_score_array[other(player)], 4, theirs);
+	for (i = 0; i < SCORE_MASK_WORDS; i++)
+		either[i] = mine[i] | theirs[i];
 
-	for (i = 0; i<57; i++) {
-		if (current_score_array[player][i] == 4) {  // forced win ߻ų  ִ 캻 
+	for (i = next_line(either, 0); i >= 0 && i<57; i = next_line(either, i + 1)) {
+		if (has_line(mine, i)) {  // forced win ߻ų  ִ 캻 
 			if (i<24) {      //horizontal winning row  
 				y = i / 4;
 				x = i % 4;
 				z = x + 4;   //row    ǥ 
 				while (x<z) {
-					if ((current_state->board[x][y] == C4_NONE) && (current_state->board[x][y - 1] != C4_NONE)) {
-						push_state();
-						current_score_array = current_state->score_array;
-						drop_piece(real_player(player), x);
-						for (k = 0; map[x][y][k] != -1; k++) {
-							win_index = map[x][y][k];
+					if ((board_cell(ctx, x, y) == C4_NONE) && (board_cell(ctx, x, y - 1) != C4_NONE)) {
+						drop_piece(&ctx->game_search, real_player(player), x);
+						found = false;
+						for (k = map_begin(x, y); k < map_end(x, y); k++) {
+							win_index = map_lines[k];
 							if ((win_index>23) && (current_score_array[player][win_index] == 8)) {
-								pop_state();
-								if (colArr[x] == min) return x; //column ȯ
-								printf(" *Rule 5 was rejected by Rule 6\n");
+								found = true;
+								break;
 							}
 						}
-						pop_state();
-						current_score_array = current_state->score_array;
+						undo_piece(&ctx->game_search);
+						if (found) {
+							if (colArr[x] == min) return x; //column ȯ
+							trace_rule(ctx, 5, C4_RULE_REJECTED);
+						}
 					}
 					x++;
 				}
@@ -1535,20 +4908,21 @@ rule5(int player, int *colArr, int min) {   //rule5
 				z = i - 24;
 				x = z / 3;
 				y = z % 3;
-				push_state();
-				current_score_array = current_state->score_array;
-				drop_piece(real_player(player), x);
-				while (map[x][y + 2][k] != -1) {  //
-					win_index = map[x][y + 2][k];
-					if ((win_index>44) && (current_score_array[player][win_index] == 8)) {
-						pop_state();
+				if (drop_piece(&ctx->game_search, real_player(player), x) >= 0) {
+					found = false;
+					for (k = map_begin(x, y + 2); k < map_end(x, y + 2); k++) {  //
+						win_index = map_lines[k];
+						if ((win_index>44) && (current_score_array[player][win_index] == 8)) {
+							found = true;
+							break;
+						}
+					}
+					undo_piece(&ctx->game_search);
+					if (found) {
 						if (colArr[x] == min) return x; //column ȯ
-						printf(" *Rule 5 was rejected by Rule 6\n");
+						trace_rule(ctx, 5, C4_RULE_REJECTED);
 					}
-					k++;
 				}
-				pop_state();
-				current_score_array = current_state->score_array;
 			}
 			else if (i<57) {   //forward diagonal winning row  
 				z = i - 45;
@@ -1556,45 +4930,47 @@ rule5(int player, int *colArr, int min) {   //rule5
 				y = z / 4;
 				z = x + 4;
 				while (x<z) {
-					if ((current_state->board[x][y] == C4_NONE) && (current_state->board[x][y - 1] != C4_NONE)) {
-						push_state();
-						current_score_array = current_state->score_array;
-						drop_piece(real_player(player), x);
-						for (k = 0; map[x][y][k] != -1; k++) {
-							win_index = map[x][y][k];
+					if ((board_cell(ctx, x, y) == C4_NONE) && (board_cell(ctx, x, y - 1) != C4_NONE)) {
+						drop_piece(&ctx->game_search, real_player(player), x);
+						found = false;
+						for (k = map_begin(x, y); k < map_end(x, y); k++) {
+							win_index = map_lines[k];
 							if ((win_index>56) && (current_score_array[player][win_index] == 8)) {
-								pop_state();
-								if (colArr[x] == min) return x; //column ȯ
-								printf(" *Rule 5 was rejected by Rule 6\n");
+								found = true;
+								break;
 							}
 						}
-						pop_state();
-						current_score_array = current_state->score_array;
+						undo_piece(&ctx->game_search);
+						if (found) {
+							if (colArr[x] == min) return x; //column ȯ
+							trace_rule(ctx, 5, C4_RULE_REJECTED);
+						}
 					}
 					x++, y++;
 				}
 			}
 		}
-		if (current_score_array[other(player)][i] == 4) {   // forced win Ȳ ߻ Ѵ 
+		if (has_line(theirs, i)) {   // forced win Ȳ ߻ Ѵ 
 			if (i<24) {  //horizontal
 				y = i / 4;
 				x = i % 4;
 				z = x + 4;
 				while (x<z) {
-					if ((current_state->board[x][y] == C4_NONE) && (current_state->board[x][y - 1] != C4_NONE)) {
-						push_state();
-						current_score_array = current_state->score_array;
-						drop_piece(other(player), x);
-						for (k = 0; map[x][y][k] != -1; k++) {
-							win_index = map[x][y][k];
+					if ((board_cell(ctx, x, y) == C4_NONE) && (board_cell(ctx, x, y - 1) != C4_NONE)) {
+						drop_piece(&ctx->game_search, other(player), x);
+						found = false;
+						for (k = map_begin(x, y); k < map_end(x, y); k++) {
+							win_index = map_lines[k];
 							if ((win_index>23) && (current_score_array[other(player)][win_index] == 8)) {
-								pop_state();
-								if (colArr[x] == min) return x; //column ȯ
-								printf(" *Rule 5 was rejected by Rule 6\n");
+								found = true;
+								break;
 							}
 						}
-						pop_state();
-						current_score_array = current_state->score_array;
+						undo_piece(&ctx->game_search);
+						if (found) {
+							if (colArr[x] == min) return x; //column ȯ
+							trace_rule(ctx, 5, C4_RULE_REJECTED);
+						}
 					}
 					x++;
 				}
@@ -1603,21 +4979,21 @@ rule5(int player, int *colArr, int min) {   //rule5
 				z = i - 24;
 				x = z / 3;
 				y = z % 3;
-				push_state();
-				current_score_array = current_state->score_array;
-				drop_piece(other(player), x);
-				while (map[x][y + 2][k] != -1) {
-					win_index = map[x][y + 2][k];
-					if ((win_index>44) && (current_score_array[other(player)][win_index] == 8)) {
-						pop_state();
+				if (drop_piece(&ctx->game_search, other(player), x) >= 0) {
+					found = false;
+					for (k = map_begin(x, y + 2); k < map_end(x, y + 2); k++) {
+						win_index = map_lines[k];
+						if ((win_index>44) && (current_score_array[other(player)][win_index] == 8)) {
+							found = true;
+							break;
+						}
+					}
+					undo_piece(&ctx->game_search);
+					if (found) {
 						if (colArr[x] == min) return x; //column ȯ
-						printf(" *Rule 5 was rejected by Rule 6\n");
+						trace_rule(ctx, 5, C4_RULE_REJECTED);
 					}
-					k++;
 				}
-				pop_state();
-				current_score_array = current_state->score_array;
-
 			}
 
 			else if (i<57) {
@@ -1626,20 +5002,21 @@ rule5(int player, int *colArr, int min) {   //rule5
 				y = z / 4;
 				z = x + 4;
 				while (x<z) {
-					if ((current_state->board[x][y] == C4_NONE) && (current_state->board[x][y - 1] != C4_NONE)) {
-						push_state();
-						current_score_array = current_state->score_array;
-						drop_piece(other(player), x);
-						for (k = 0; map[x][y][k] != -1; k++) {
-							win_index = map[x][y][k];
+					if ((board_cell(ctx, x, y) == C4_NONE) && (board_cell(ctx, x, y - 1) != C4_NONE)) {
+						drop_piece(&ctx->game_search, other(player), x);
+						found = false;
+						for (k = map_begin(x, y); k < map_end(x, y); k++) {
+							win_index = map_lines[k];
 							if ((win_index>56) && (current_score_array[other(player)][win_index] == 8)) {
-								pop_state();
-								if (colArr[x] == min) return x; //column ȯ
-								printf(" *Rule 5 was rejected by Rule 6\n");
+								found = true;
+								break;
 							}
 						}
-						pop_state();
-						current_score_array = current_state->score_array;
+						undo_piece(&ctx->game_search);
+						if (found) {
+							if (colArr[x] == min) return x; //column ȯ
+							trace_rule(ctx, 5, C4_RULE_REJECTED);
+						}
 					}
 					x++, y++;
 				}
@@ -1662,7 +5039,7 @@ rule5(int player, int *colArr, int min) {   //rule5
 *  ۼ
 */
 
-void rule6(int player, int* colArr) {
+void rule6(c4_ctx *ctx, int player, int* colArr) {
 	//colArr must be int array of size 7, -1 if not applicable rule6, bigger the number higher possibility rule6
 
 	int winLineArr[70];
@@ -1681,19 +5058,19 @@ void rule6(int player, int* colArr) {
 		winLineArr[i] = -1;
 	} // initialize winLineArr for storing WinningPositions with score 8
 
-	r12_winning8check(other(player), winLineArr);
+	r12_winning8check(ctx, other(player), winLineArr);
 
 	for (i = 0; winLineArr[i] != -1; i++) {
 		if (winLineArr[i] < 24) { // horizontal WinningPositions
 			x = winLineArr[i] % 4; // lower left col value of WinningPosition
 			y = winLineArr[i] / 4; // lower left row value of WinningPosition
 			for (j = 0; j < 4; j++) {
-				if (current_state->board[x + j][y] == C4_NONE) {
+				if (board_cell(ctx, x + j, y) == C4_NONE) {
 					jx = x + j; iy = y; //empty coordinate
-					if (iy - 1 == 0 && current_state->board[jx][iy - 1] == C4_NONE) {
+					if (iy - 1 == 0 && board_cell(ctx, jx, iy - 1) == C4_NONE) {
 						colArr[jx]++;
 					}
-					else if (iy - 1 > 0 && current_state->board[jx][iy - 1] == C4_NONE && current_state->board[jx][iy - 2] != C4_NONE) {
+					else if (iy - 1 > 0 && board_cell(ctx, jx, iy - 1) == C4_NONE && board_cell(ctx, jx, iy - 2) != C4_NONE) {
 						colArr[jx]++;
 					}
 				}
@@ -1707,13 +5084,13 @@ void rule6(int player, int* colArr) {
 			x = z % 4; // lower left
 			y = z / 4; // lower left
 			for (j = 0; j < 4; j++) {
-				if (current_state->board[x + j][y + j] == C4_NONE) {
+				if (board_cell(ctx, x + j, y + j) == C4_NONE) {
 					jx = x + j; iy = y + j; // empty coordinate
-					if (iy - 1 == 0 && current_state->board[jx][iy - 1] == C4_NONE) {
+					if (iy - 1 == 0 && board_cell(ctx, jx, iy - 1) == C4_NONE) {
 						// not applicable in this case - will be caught by rule 2 but just in case
 						colArr[jx]++;
 					}
-					else if (iy - 1 > 0 && current_state->board[jx][iy - 1] == C4_NONE && current_state->board[jx][iy - 2] != C4_NONE) {
+					else if (iy - 1 > 0 && board_cell(ctx, jx, iy - 1) == C4_NONE && board_cell(ctx, jx, iy - 2) != C4_NONE) {
 						colArr[jx]++;
 					}
 				}
@@ -1724,13 +5101,13 @@ void rule6(int player, int* colArr) {
 			x = 6 - (z % 4);
 			y = z / 4;
 			for (j = 0; j < 4; j++) {
-				if (current_state->board[x - j][y + j] == C4_NONE) {
+				if (board_cell(ctx, x - j, y + j) == C4_NONE) {
 					jx = x - j; iy = y + j;
-					if (iy - 1 == 0 && current_state->board[jx][iy - 1] == C4_NONE) {
+					if (iy - 1 == 0 && board_cell(ctx, jx, iy - 1) == C4_NONE) {
 						// not applicable in this case - will be caught by rule 2 but just in case
 						colArr[jx]++;
 					}
-					else if (iy - 1 > 0 && current_state->board[jx][iy - 1] == C4_NONE && current_state->board[jx][iy - 2] != C4_NONE) {
+					else if (iy - 1 > 0 && board_cell(ctx, jx, iy - 1) == C4_NONE && board_cell(ctx, jx, iy - 2) != C4_NONE) {
 						colArr[jx]++;
 					}
 				}
@@ -1746,12 +5123,13 @@ void rule6(int player, int* colArr) {
 * @function defaultRule
 *
 * @param player (0) Ǵ ǻ(1)
-* @param column   column  ϱ  
+* @param column   column  ϱ  .   ʴ´.
 * @param colArr Rule6  迭
 * @param min colArr ּҰ
 * @return   ǥ row  Ѵ
 *
 * ռ 鿡 ɸ ʾ  Ǵ Լ̴.
+*     undo_log  ϵ column̴.
 *       ⺻,      rowٸ
 *  column ߿   ڸ  column    ׿ ִ column   ´.
 * Column ̰    column ִٸ drop_order 迭  .
@@ -1759,26 +5137,29 @@ void rule6(int player, int* colArr) {
 *  ۼ
 */
 
-int defaultRule(int player, int *column, int* colArr, int min) {
+int defaultRule(c4_ctx *ctx, int player, int *column, int* colArr, int min) {
 
-	int i, x = 0, largest = -1, col, y = 0;
+	int i, x = 0, largest = -1, col, y = 0, last;
 
-	if (current_state->num_of_pieces == 0) {                 //ù° ÷̾  ù  2 or 4 column 
+	if (ctx->current_state->num_of_pieces == 0) {                 //ù° ÷̾  ù  2 or 4 column 
 		if ((rand() % 2) == 0) {
 			if (column != NULL) *column = 2;
-			return drop_piece(real_player(player), 2);
+			return drop_piece(&ctx->game_search, real_player(player), 2);
 		}
 		else {
 			if (column != NULL) *column = 4;
-			return drop_piece(real_player(player), 4);
+			return drop_piece(&ctx->game_search, real_player(player), 4);
 		}
 	}
 
-	while (current_state->board[*column][y] != C4_NONE && ++y < size_y)
-		;
+	last = ctx->game_search.undo_log[ctx->current_state->num_of_pieces - 1].column;
+	y = column_height(ctx->current_state, last);
 
 	if (y != size_y) {              //    ´
-		if (colArr[*column] == min) return drop_piece(real_player(player), *column);
+		if (colArr[last] == min) {
+			if (column != NULL) *column = last;
+			return drop_piece(&ctx->game_search, real_player(player), last);
+		}
 	}
 	for (i = 0; i<7; i++) {     //밡 column  ĭ        column  д
 		y = 0;
@@ -1786,8 +5167,7 @@ int defaultRule(int player, int *column, int* colArr, int min) {
 
 		if (colArr[i] != min) continue;
 
-		while (current_state->board[col][y] != C4_NONE && ++y < size_y)   //col  ڸ row ã´ 
-			;
+		y = column_height(ctx->current_state, col);   //col  ڸ row ã´ 
 		if (y == size_y) continue;
 
 		if (y > largest) {
@@ -1796,9 +5176,20 @@ int defaultRule(int player, int *column, int* colArr, int min) {
 		}
 	}
 
-	if (y != size_y) {     //game is not tie
-		*column = x;
-		return drop_piece(real_player(player), x);
+	if (largest < 0) {      //colArr min column  áٸ  column     column  д
+		for (i = 0; i<7; i++) {
+			col = drop_order[i];
+			y = column_height(ctx->current_state, col);
+			if (y != size_y && y > largest) {
+				largest = y;
+				x = col;
+			}
+		}
+	}
+
+	if (largest >= 0) {     //game is not tie
+		if (column != NULL) *column = x;
+		return drop_piece(&ctx->game_search, real_player(player), x);
 	}
 	else return -1;
 }
@@ -1818,7 +5209,23 @@ int defaultRule(int player, int *column, int* colArr, int min) {
 *  ۼ
 */
 
-void heuristicDropOrder(int player, int* dropOrder) {
+void heuristicDropOrder(c4_ctx *ctx, int player, int* dropOrder) {
+	heuristic_drop_order(ctx->current_state, player, dropOrder);
+}
+
+
+
+/**
+* @function heuristic_drop_order
+*
+* @param state column   Game_state
+* @param player     (0) Ǵ ǻ(1)
+* @param dropOrder Heuristic  , Ž column  ϱ  
+*
+* heuristicDropOrder() ,     Ž  thread Game_state  Ѵ.
+*/
+
+static void heuristic_drop_order(const Game_state *state, int player, int* dropOrder) {
 	int i, j, y, r, k;
 	int rowArr[7];
 	int scoreArr[7];
@@ -1828,22 +5235,17 @@ void heuristicDropOrder(int player, int* dropOrder) {
 	}
 
 	for (i = 0; i < 7; i++) {              //store value of possible col, row coordinates in rowArr
-		y = 0;
-
-		while (current_state->board[i][y] != C4_NONE && ++y < size_y)   //col  ڸ row ã´ 
-			;
+		y = column_height(state, i);   //col  ڸ row ã´ 
 
 		rowArr[i] = y;
 	}
 
 	for (i = 0; i < 7; i++) { //  column 
-		j = 0;
 		r = rowArr[i];
 		if (r == 6) continue;
-		while (map[i][r][j] != -1) { // winning Line 
-			k = map[i][r][j];
-			scoreArr[i] += current_state->score_array[player][k]; //ش winning line score ϱ, scoreArr  col sum of score
-			j++;
+		for (j = map_begin(i, r); j < map_end(i, r); j++) { // winning Line 
+			k = map_lines[j];
+			scoreArr[i] += state->score_array[player][k]; //ش winning line score ϱ, scoreArr  col sum of score
 		}
 	}
 
@@ -46,11 +46,29 @@
 
 #include <stdbool.h>
 
+#include <stdint.h>
+
 
 #define C4_NONE      2
 
 #define C4_MAX_LEVEL 20
 
+#define C4_MAX_THREADS 64
+
+#define C4_SMP_LAZY  0
+
+#define C4_SMP_SPLIT 1
+
+#define C4_SEARCH_ALPHABETA  0
+
+#define C4_SEARCH_MTDF       1
+
+#define C4_SEARCH_ASPIRATION 2
+
+#define C4_ENGINE_SEARCH 0
+
+#define C4_ENGINE_RULE   1
+
 #define WIDTH    7
 
 #define HEIGHT    6
@@ -58,17 +76,242 @@
 #define NUM_TO_CONNECT 4
 
 
+/* The opening book file written by book.c: a c4_book_header followed by */
+
+/* count c4_book_entry records sorted by key, in the machine's byte order. */
+
+
+#define C4_BOOK_MAGIC   "C4BOOK\0\0"
+
+#define C4_BOOK_VERSION 1
+
+
+typedef struct {
+
+    char     magic[8];      /* C4_BOOK_MAGIC */
+
+    uint32_t version;       /* C4_BOOK_VERSION */
+
+    uint16_t width, height; /* WIDTH and HEIGHT of the engine that wrote it */
+
+    uint32_t plies;         /* positions with fewer pieces than this were searched */
+
+    uint32_t level;         /* search level used for every entry */
+
+    uint64_t count;         /* number of entries that follow */
+
+} c4_book_header;
+
+
+typedef struct {
+
+    uint64_t key;           /* c4_position_key() of the position */
+
+    int32_t  goodness;      /* goodness of column for the player to move */
+
+    uint8_t  column;        /* best column, on the board the key was taken from */
+
+    uint8_t  level;
+
+    uint8_t  reserved[2];
+
+} c4_book_entry;
+
+
+/* Events passed to the function given to c4_set_trace(). */
+
+
+#define C4_TRACE_COLUMN 0   /* column, goodness: result of one root column */
+
+#define C4_TRACE_THREAD 1   /* thread, nodes: nodes searched by one thread */
+
+#define C4_TRACE_MTDF   2   /* passes, goodness: result of an MTD(f) search */
+
+#define C4_TRACE_RULE   3   /* rule, verdict: a decision of the rule-based player */
+
+#define C4_TRACE_ERROR  4   /* message, thread: a problem the engine worked around */
+
+
+#define C4_RULE_CHECKED  0
+
+#define C4_RULE_USED     1
+
+#define C4_RULE_REJECTED 2  /* rejected by rule 6 */
+
+
+typedef struct {
+
+    int           kind;     /* C4_TRACE_... */
+
+    int           column;
+
+    int           goodness;
+
+    int           thread;
+
+    unsigned long nodes;
+
+    int           passes;
+
+    int           rule;     /* 1-5, or 0 for the default rule */
+
+    int           verdict;  /* C4_RULE_... */
+
+    const char   *message;
+
+} c4_trace_event;
+
+
+typedef void (*c4_trace_func)(const c4_trace_event *event, void *data);
+
+
+/* What the last search did, filled in by c4_get_search_stats(). */
+
+/* All counts are summed over the search threads. */
+
+
+typedef struct {
+
+    unsigned long nodes;
+
+    unsigned long leaf_nodes;       /* nodes whose moves were not searched */
+
+    unsigned long interior_nodes;   /* nodes whose moves were searched */
+
+    unsigned long ply_nodes[WIDTH * HEIGHT + 1];    /* nodes by plies from the root */
+
+    int           max_depth;        /* deepest ply reached */
+
+    unsigned long cutoffs;          /* beta cutoffs, by the search and the solver */
+
+    unsigned long cutoff_index[WIDTH];  /* cutoffs by the index of the move that caused them */
+
+    unsigned long column_nodes[WIDTH];  /* nodes below each root column */
+
+    double        column_ms[WIDTH];     /* time spent below each root column */
+
+} c4_search_stats;
+
+
 /* See the file "c4.c" for documentation on the following functions. */
 
 
+typedef struct c4_ctx c4_ctx;
+
+extern c4_ctx *c4_ctx_new(void);
+
+extern void    c4_ctx_free(c4_ctx *ctx);
+
+extern void    c4_ctx_poll(c4_ctx *ctx, void(*poll_func)(void), clock_t interval);
+
+extern void    c4_ctx_set_hash_size(c4_ctx *ctx, int megabytes);
+
+extern void    c4_ctx_set_solver_threshold(c4_ctx *ctx, int empty_cells);
+
+extern void    c4_ctx_set_threads(c4_ctx *ctx, int threads);
+
+extern void    c4_ctx_set_smp_mode(c4_ctx *ctx, int mode);
+
+extern void    c4_ctx_set_search_mode(c4_ctx *ctx, int mode);
+
+extern void    c4_ctx_set_engine(c4_ctx *ctx, int engine);
+
+extern void    c4_ctx_set_trace(c4_ctx *ctx, c4_trace_func trace_func, void *data);
+
+extern bool    c4_ctx_load_book(c4_ctx *ctx, const char *path);
+
+extern bool    c4_ctx_open_solved_cache(c4_ctx *ctx, const char *path, int megabytes);
+
+extern unsigned long c4_ctx_thread_nodes(c4_ctx *ctx, int thread);
+
+extern void    c4_ctx_hash_stats(c4_ctx *ctx, unsigned long *hits,
+
+                                 unsigned long *misses, unsigned long *collisions);
+
+extern void    c4_ctx_cutoff_stats(c4_ctx *ctx, unsigned long *cutoffs,
+
+                                   unsigned long *first_move_cutoffs);
+
+extern void    c4_ctx_get_search_stats(c4_ctx *ctx, c4_search_stats *stats);
+
+extern void    c4_ctx_new_game(c4_ctx *ctx);
+
+extern bool    c4_ctx_make_move(c4_ctx *ctx, int player, int column, int row);
+
+extern bool    c4_ctx_auto_move(c4_ctx *ctx, int player, int level, int *column, int *row);
+
+extern bool    c4_ctx_auto_move_timed(c4_ctx *ctx, int player, int budget_ms, int *column, int *row);
+
+extern int     c4_ctx_search(c4_ctx *ctx, int player, int level, int *goodness);
+
+extern int     c4_ctx_search_timed(c4_ctx *ctx, int player, int budget_ms, int *goodness, int *depth);
+
+extern void    c4_ctx_rule_auto_move(c4_ctx *ctx, int player, int *column, int *row);
+
+extern char ** c4_ctx_board(c4_ctx *ctx);
+
+extern int     c4_ctx_score_of_player(c4_ctx *ctx, int player);
+
+extern bool    c4_ctx_is_winner(c4_ctx *ctx, int player);
+
+extern bool    c4_ctx_is_tie(c4_ctx *ctx);
+
+extern void    c4_ctx_win_coords(c4_ctx *ctx, int *x1, int *y1, int *x2, int *y2);
+
+extern uint64_t c4_ctx_position_key(c4_ctx *ctx, int player, bool *mirrored);
+
+extern int     c4_ctx_principal_variation(c4_ctx *ctx, int player, int column, int *pv, int max_length);
+
+extern void    c4_ctx_stop(c4_ctx *ctx);
+
+extern void    c4_ctx_end_game(c4_ctx *ctx);
+
+
+/* The following functions use one default c4_ctx shared by the whole program. */
+
+
 extern void    c4_poll(void(*poll_func)(void), clock_t interval);
 
+extern void    c4_set_hash_size(int megabytes);
+
+extern void    c4_set_solver_threshold(int empty_cells);
+
+extern void    c4_set_threads(int threads);
+
+extern void    c4_set_smp_mode(int mode);
+
+extern void    c4_set_search_mode(int mode);
+
+extern void    c4_set_engine(int engine);
+
+extern void    c4_set_trace(c4_trace_func trace_func, void *data);
+
+extern bool    c4_load_book(const char *path);
+
+extern bool    c4_open_solved_cache(const char *path, int megabytes);
+
+extern unsigned long c4_thread_nodes(int thread);
+
+extern void    c4_hash_stats(unsigned long *hits, unsigned long *misses,
+
+                             unsigned long *collisions);
+
+extern void    c4_cutoff_stats(unsigned long *cutoffs, unsigned long *first_move_cutoffs);
+
+extern void    c4_get_search_stats(c4_search_stats *stats);
+
 extern void    c4_new_game(void);
 
 extern bool    c4_make_move(int player, int column, int row);
 
 extern bool    c4_auto_move(int player, int level, int *column, int *row);
 
+extern bool    c4_auto_move_timed(int player, int budget_ms, int *column, int *row);
+
+extern int     c4_search(int player, int level, int *goodness);
+
+extern int     c4_search_timed(int player, int budget_ms, int *goodness, int *depth);
+
 extern char ** c4_board(void);
 
 extern int     c4_score_of_player(int player);
@@ -79,19 +322,25 @@ extern bool    c4_is_tie(void);
 
 extern void    c4_win_coords(int *x1, int *y1, int *x2, int *y2);
 
+extern uint64_t c4_position_key(int player, bool *mirrored);
+
+extern int     c4_principal_variation(int player, int column, int *pv, int max_length);
+
+extern void    c4_stop(void);
+
 extern void    c4_end_game(void);
 
 extern void    c4_rule_auto_move(int player, int *column, int *row);
-extern void heuristicDropOrder(int player, int* dropOrder);
+extern void heuristicDropOrder(c4_ctx *ctx, int player, int* dropOrder);
 
 
 //extern int rule1(int player);
 
-extern int rule1_1(int player);
+extern int rule1_1(c4_ctx *ctx, int player);
 
 //extern int rule2(int player);
 
-extern int rule2_1(int player);
+extern int rule2_1(c4_ctx *ctx, int player);
 
 /*extern int r12_horizontal3Check(int col, int row, int player);
 
@@ -101,28 +350,28 @@ extern int r12_posDiagonal3Check(int col, int row, int player);
 
 extern int r12_vertical3Check(int col, int row, int player);*/
 
-extern void r12_winning8check(int player, int * winLineArr);
+extern void r12_winning8check(c4_ctx *ctx, int player, int * winLineArr);
 
 
 
 
-extern int rule3(int player);
+extern int rule3(c4_ctx *ctx, int player);
 
-extern int rule4(int player);
+extern int rule4(c4_ctx *ctx, int player);
 
-extern int r34_diagonalCheckPos(int player, int col, int row);
+extern int r34_diagonalCheckPos(c4_ctx *ctx, int player, int col, int row);
 
-extern int r34_diagonalCheckNeg(int player, int col, int row);
+extern int r34_diagonalCheckNeg(c4_ctx *ctx, int player, int col, int row);
 
-extern int r34_horizontalCheck(int player, int col, int row);
+extern int r34_horizontalCheck(c4_ctx *ctx, int player, int col, int row);
 
-extern int rule5(int player, int * colArr, int min);
+extern int rule5(c4_ctx *ctx, int player, int * colArr, int min);
 
 
-extern void rule6(int player, int* colArr);
+extern void rule6(c4_ctx *ctx, int player, int* colArr);
 
 
-extern int defaultRule(int player, int *column, int * colArr, int min);
+extern int defaultRule(c4_ctx *ctx, int player, int *column, int * colArr, int min);
 
 
 #endif /* C4_DEFINED */
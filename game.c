@@ -73,6 +73,8 @@ static void print_board(void);
 
 static void print_dot(void);
 
+static void print_trace(const c4_trace_event *event, void *data);
+
 
 static char piece[2] = { 'X', 'O' };
 
@@ -85,7 +87,7 @@ main()
 
 	int player[2], level[2], turn = 0, num_of_players, move;
 
-	int x1, y1, x2, y2, r, c;
+	int x1, y1, x2, y2, r, c, choice, landed;
 
 	char buffer[80];
 
@@ -131,6 +133,8 @@ main()
 
 	c4_poll(print_dot, CLOCKS_PER_SEC / 2);
 
+	c4_set_trace(print_trace, NULL);
+
 
 	do {
 
@@ -148,11 +152,25 @@ main()
 
 			} while (!(c4_make_move(turn, move, r - 1)));
 
+			for (landed = HEIGHT - 1; c4_board()[move][landed] == C4_NONE; landed--)
+
+				; //  column  Ʒ  ĭ .
+
+			printf("\n * I dropped my piece on (%d, %d).\n", landed + 1, c);
+
 		}
 
 
 		else {
 
+			printf(" (Heuristic : 1, Rule : 2)\n * Move choice : ");
+
+			scanf("%d", &choice);
+
+			printf("\n");
+
+			c4_set_engine((choice == 2) ? C4_ENGINE_RULE : C4_ENGINE_SEARCH);
+
 			fflush(stdout);
 
 			c4_auto_move(turn, level[turn], &move, &x1);
@@ -398,6 +416,83 @@ print_dot(void)
 }
 
 
+/**
+
+* @function print_trace
+
+*
+
+* c4_set_trace()  engine event ó Ѵ.
+
+* Ž column goodness, thread  , ׸  rule Ǿ ش.
+
+*/
+
+
+
+static void
+
+print_trace(const c4_trace_event *event, void *data)
+
+{
+
+	static const char *rule_names[] = { "Default rule", "Rule 1", "Rule 2", "Rule 3", "Rule 4", "Rule 5" };
+
+
+
+	(void)data;
+
+	switch (event->kind) {
+
+	case C4_TRACE_COLUMN:
+
+		printf(" | Current column : %d, goodness : %d\n", event->column + 1, event->goodness);
+
+		break;
+
+	case C4_TRACE_THREAD:
+
+		printf(" | Thread %d : %lu nodes\n", event->thread, event->nodes);
+
+		break;
+
+	case C4_TRACE_MTDF:
+
+		printf(" | MTD(f) : %d passes, goodness : %d\n", event->passes, event->goodness);
+
+		break;
+
+	case C4_TRACE_RULE:
+
+		if (event->verdict == C4_RULE_CHECKED)
+
+			printf(" * %s is being checked.\n", rule_names[event->rule]);
+
+		else if (event->verdict == C4_RULE_REJECTED)
+
+			printf(" * %s was rejected by Rule 6.\n", rule_names[event->rule]);
+
+		else if (event->rule == 0 || event->rule == 5)
+
+			printf(" * %s & Rule 6 used.\n", rule_names[event->rule]);
+
+		else
+
+			printf(" * %s is used.\n", rule_names[event->rule]);
+
+		break;
+
+	case C4_TRACE_ERROR:
+
+		fprintf(stderr, "c4: %s\n", event->message);
+
+		break;
+
+	}
+
+}
+
+
 
 
 
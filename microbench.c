@@ -0,0 +1,461 @@
+/***************************************************************************
+**                                                                        **
+**                     Connect-4 Primitive Micro-Benchmarks               **
+**                                                                        **
+****************************************************************************
+**                                                                        **
+**  Measures what the engine's building blocks cost, one at a time, on    **
+**  random positions, so that an optimization can be judged by numbers.   **
+**                                                                        **
+**  usage: microbench [rounds [seed]]                                     **
+**                                                                        **
+**  Every primitive is called BATCH times in a row on each of POSITIONS   **
+**  random positions, and this is repeated <rounds> times (default 20).   **
+**  The first WARMUP_ROUNDS rounds are not counted.  The time of every    **
+**  batch divided by BATCH is one sample; the report gives the mean, the  **
+**  median (p50) and the 99th percentile (p99) of the samples in ns/op.   **
+**                                                                        **
+**  drop_piece() is measured together with the undo_piece() that takes    **
+**  the piece back, since the search always pairs them.  c4_win_coords()  **
+**  is measured on positions where the last move won the game.            **
+**                                                                        **
+**  This file includes c4.c so that it can call the static functions:     **
+**  build it without c4.c.                                                **
+**                                                                        **
+***************************************************************************/
+
+#include "c4.c"
+
+#define POSITIONS     256
+#define BATCH         256
+#define WARMUP_ROUNDS 2
+#define DEFAULT_ROUNDS 20
+
+/**
+* Position ü  忡     ̴.
+*/
+
+typedef struct {
+
+	int columns[WIDTH * HEIGHT];
+
+	int count;
+
+} Position;
+
+/**
+* Primitive ü  Լ ϳ̴.
+*/
+
+typedef struct {
+
+	const char *name;
+
+	long (*run)(c4_ctx *ctx, int player, int iterations);	// iterations θ,    ش
+
+	bool won;           	//   鿡 Ѵ
+
+} Primitive;
+
+static long run_drop_piece(c4_ctx *ctx, int player, int iterations);
+static long run_update_score(c4_ctx *ctx, int player, int iterations);
+static long run_heuristic_drop_order(c4_ctx *ctx, int player, int iterations);
+static long run_winning8check(c4_ctx *ctx, int player, int iterations);
+static long run_rule1_1(c4_ctx *ctx, int player, int iterations);
+static long run_rule2_1(c4_ctx *ctx, int player, int iterations);
+static long run_rule3(c4_ctx *ctx, int player, int iterations);
+static long run_rule4(c4_ctx *ctx, int player, int iterations);
+static long run_rule5(c4_ctx *ctx, int player, int iterations);
+static long run_rule6(c4_ctx *ctx, int player, int iterations);
+static long run_win_coords(c4_ctx *ctx, int player, int iterations);
+static void make_positions(Position *positions, bool won, uint64_t *random_state);
+static int set_position(c4_ctx *ctx, const Position *position);
+static int legal_columns(c4_ctx *ctx, int *columns);
+static uint64_t next_random(uint64_t *state);
+static int compare_doubles(const void *a, const void *b);
+static double elapsed_ns(const struct timespec *start);
+
+static const Primitive primitives[] = {
+	{ "drop_piece+undo_piece", run_drop_piece, false },
+	{ "update_score", run_update_score, false },
+	{ "heuristicDropOrder", run_heuristic_drop_order, false },
+	{ "r12_winning8check", run_winning8check, false },
+	{ "rule1_1", run_rule1_1, false },
+	{ "rule2_1", run_rule2_1, false },
+	{ "rule3", run_rule3, false },
+	{ "rule4", run_rule4, false },
+	{ "rule5", run_rule5, false },
+	{ "rule6", run_rule6, false },
+	{ "c4_win_coords", run_win_coords, true },
+};
+
+static Position open_positions[POSITIONS], won_positions[POSITIONS];
+static volatile long sink;	// Ϸ   ʴ ȣ  ϰ Ѵ
+
+
+
+int
+main(int argc, char *argv[])
+{
+	int rounds = DEFAULT_ROUNDS, num_samples, round, p, i, player;
+	uint64_t random_state;
+	double *samples, total;
+	struct timespec start;
+	const Position *positions;
+	c4_ctx *ctx;
+
+	if (argc > 3) {
+		fprintf(stderr, "usage: %s [rounds [seed]]\n", argv[0]);
+		return 2;
+	}
+	if (argc >= 2)
+		rounds = atoi(argv[1]);
+	if (rounds <= WARMUP_ROUNDS) {
+		fprintf(stderr, "%s: rounds must be more than %d.\n", argv[0], WARMUP_ROUNDS);
+		return 2;
+	}
+	random_state = argc >= 3 ? strtoull(argv[2], NULL, 10) : 1;
+
+	ctx = c4_ctx_new();
+	make_positions(open_positions, false, &random_state);
+	make_positions(won_positions, true, &random_state);
+	samples = (double *)emalloc(sizeof(double) * POSITIONS * rounds);
+
+	printf("%-24s %10s %10s %10s\n", "primitive", "mean ns", "p50 ns", "p99 ns");
+	for (i = 0; i < (int)(sizeof(primitives) / sizeof(primitives[0])); i++) {
+		positions = primitives[i].won ? won_positions : open_positions;
+		num_samples = 0;
+		total = 0;
+		for (round = 0; round < rounds; round++) {
+			for (p = 0; p < POSITIONS; p++) {
+				player = set_position(ctx, &positions[p]);
+				timespec_get(&start, TIME_UTC);
+				sink += primitives[i].run(ctx, player, BATCH);
+				if (round >= WARMUP_ROUNDS) {
+					samples[num_samples] = elapsed_ns(&start) / BATCH;
+					total += samples[num_samples++];
+				}
+				c4_ctx_end_game(ctx);
+			}
+		}
+		qsort(samples, num_samples, sizeof(double), compare_doubles);
+		printf("%-24s %10.1f %10.1f %10.1f\n", primitives[i].name, total / num_samples,
+			samples[num_samples / 2], samples[num_samples * 99 / 100]);
+	}
+
+	free(samples);
+	c4_ctx_free(ctx);
+	return 0;
+}
+
+
+
+/**
+* @function run_drop_piece
+*
+*   ִ column鿡 ʷ   ٷ ǵ.
+*/
+
+static long
+run_drop_piece(c4_ctx *ctx, int player, int iterations)
+{
+	int columns[WIDTH], count, i;
+	long result = 0;
+
+	count = legal_columns(ctx, columns);
+	for (i = 0; i < iterations; i++) {
+		result += drop_piece(&ctx->game_search, player, columns[i % count]);
+		undo_piece(&ctx->game_search);
+	}
+	return result;
+}
+
+
+
+/**
+* @function run_update_score
+*
+*    Game_state,   ִ ĭ鿡 ʷ score ģ.
+*  ĭ    score_array  ġ ʵ,  ĭ   ĥ  score_array ǵ.
+*/
+
+static long
+run_update_score(c4_ctx *ctx, int player, int iterations)
+{
+	int columns[WIDTH], rows[WIDTH], count, i;
+	Game_state state = *ctx->current_state;
+	Undo_record undo;
+
+	count = legal_columns(ctx, columns);
+	for (i = 0; i < count; i++)
+		rows[i] = popcount64(state.mask & column_mask(columns[i]));
+	for (i = 0; i < iterations; i++) {
+		if (i % count == 0)
+			memcpy(state.score_array, ctx->current_state->score_array, sizeof(state.score_array));
+		update_score(&state, player, columns[i % count], rows[i % count], &undo);
+	}
+	return state.score[player];
+}
+
+
+
+static long
+run_heuristic_drop_order(c4_ctx *ctx, int player, int iterations)
+{
+	int order[WIDTH], i;
+	long result = 0;
+
+	for (i = 0; i < iterations; i++) {
+		heuristicDropOrder(ctx, player, order);
+		result += order[0];
+	}
+	return result;
+}
+
+
+
+static long
+run_winning8check(c4_ctx *ctx, int player, int iterations)
+{
+	int lines[70], i;
+	long result = 0;
+
+	for (i = 0; i < iterations; i++) {
+		memset(lines, -1, sizeof(lines));
+		r12_winning8check(ctx, player, lines);
+		result += lines[0];
+	}
+	return result;
+}
+
+
+
+static long
+run_rule1_1(c4_ctx *ctx, int player, int iterations)
+{
+	int i;
+	long result = 0;
+
+	for (i = 0; i < iterations; i++)
+		result += rule1_1(ctx, player);
+	return result;
+}
+
+
+
+static long
+run_rule2_1(c4_ctx *ctx, int player, int iterations)
+{
+	int i;
+	long result = 0;
+
+	for (i = 0; i < iterations; i++)
+		result += rule2_1(ctx, player);
+	return result;
+}
+
+
+
+static long
+run_rule3(c4_ctx *ctx, int player, int iterations)
+{
+	int i;
+	long result = 0;
+
+	for (i = 0; i < iterations; i++)
+		result += rule3(ctx, player);
+	return result;
+}
+
+
+
+static long
+run_rule4(c4_ctx *ctx, int player, int iterations)
+{
+	int i;
+	long result = 0;
+
+	for (i = 0; i < iterations; i++)
+		result += rule4(ctx, player);
+	return result;
+}
+
+
+
+/**
+* @function run_rule5
+*
+* c4_rule_auto_move()ó rule6()   ѱ. rule6() θ ð  ʵ   θ.
+*/
+
+static long
+run_rule5(c4_ctx *ctx, int player, int iterations)
+{
+	int counts[WIDTH], min, i;
+	long result = 0;
+
+	rule6(ctx, player, counts);
+	for (min = counts[0], i = 1; i < WIDTH; i++)
+		if (counts[i] < min)
+			min = counts[i];
+	for (i = 0; i < iterations; i++)
+		result += rule5(ctx, player, counts, min);
+	return result;
+}
+
+
+
+static long
+run_rule6(c4_ctx *ctx, int player, int iterations)
+{
+	int counts[WIDTH], i;
+	long result = 0;
+
+	for (i = 0; i < iterations; i++) {
+		rule6(ctx, player, counts);
+		result += counts[0];
+	}
+	return result;
+}
+
+
+
+static long
+run_win_coords(c4_ctx *ctx, int player, int iterations)
+{
+	int x1, y1, x2, y2, i;
+	long result = 0;
+
+	(void)player;
+	for (i = 0; i < iterations; i++) {
+		c4_ctx_win_coords(ctx, &x1, &y1, &x2, &y2);
+		result += x1 + y1 + x2 + y2;
+	}
+	return result;
+}
+
+
+
+/**
+* @function make_positions
+*
+* @param positions POSITIONS   迭
+* @param won true   ̱ , false     
+* @param random_state   
+*
+*  忡     .    4 36    ̴.
+*/
+
+static void
+make_positions(Position *positions, bool won, uint64_t *random_state)
+{
+	int columns[WIDTH], target, count, i;
+	bool decided;
+	Position *position;
+	c4_ctx *ctx = c4_ctx_new();
+
+	for (i = 0; i < POSITIONS; i++) {
+		position = &positions[i];
+		target = won ? WIDTH * HEIGHT : 4 + (int)(next_random(random_state) % 33);
+		do {
+			position->count = 0;
+			c4_ctx_new_game(ctx);
+			while (position->count < target && !c4_ctx_is_winner(ctx, 0) && !c4_ctx_is_winner(ctx, 1)) {
+				count = legal_columns(ctx, columns);
+				position->columns[position->count] = columns[next_random(random_state) % count];
+				drop_piece(&ctx->game_search, position->count & 1, position->columns[position->count]);
+				position->count++;
+			}
+			decided = c4_ctx_is_winner(ctx, 0) || c4_ctx_is_winner(ctx, 1);
+			c4_ctx_end_game(ctx);
+		} while (decided != won);
+	}
+	c4_ctx_free(ctx);
+}
+
+
+
+/**
+* @function set_position
+*
+* @return position    player
+*
+* ctx   ϰ position  ´.
+*/
+
+static int
+set_position(c4_ctx *ctx, const Position *position)
+{
+	int i;
+
+	c4_ctx_new_game(ctx);
+	for (i = 0; i < position->count; i++)
+		drop_piece(&ctx->game_search, i & 1, position->columns[i]);
+	return position->count & 1;
+}
+
+
+
+/**
+* @function legal_columns
+*
+* @param columns    ִ column  迭
+* @return    ִ column 
+*/
+
+static int
+legal_columns(c4_ctx *ctx, int *columns)
+{
+	int column, count = 0;
+
+	for (column = 0; column < WIDTH; column++)
+		if (!(ctx->current_state->mask & top_mask(column)))
+			columns[count++] = column;
+	return count;
+}
+
+
+
+/**
+* @function next_random
+*
+* @param state   
+* @return  64Ʈ  (splitmix64)
+*/
+
+static uint64_t
+next_random(uint64_t *state)
+{
+	uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+
+
+static int
+compare_doubles(const void *a, const void *b)
+{
+	double x = *(const double *)a, y = *(const double *)b;
+
+	return (x > y) - (x < y);
+}
+
+
+
+/**
+* @function elapsed_ns
+*
+* @return start ݱ 帥 ð()
+*/
+
+static double
+elapsed_ns(const struct timespec *start)
+{
+	struct timespec now;
+
+	timespec_get(&now, TIME_UTC);
+	return (now.tv_sec - start->tv_sec) * 1e9 + (now.tv_nsec - start->tv_nsec);
+}
@@ -0,0 +1,552 @@
+/***************************************************************************
+**                                                                        **
+**                       Connect-4 Engine Protocol Server                 **
+**                                                                        **
+****************************************************************************
+**                                                                        **
+**  Reads one command per line on stdin and answers on stdout, so that a  **
+**  GUI or a match arbiter can drive the engine over pipes.  Searches     **
+**  run on their own thread; "stop" is answered while they are running.  **
+**                                                                        **
+**  position [moves]     set up the board.  The moves are the columns    **
+**                       played from the empty board, counted from 1,    **
+**                       e.g. "position 4453"; player 0 moves first.     **
+**  go [depth N] [movetime MS] [infinite] [ponder]                        **
+**                       search the position.  Without a limit the       **
+**                       search gets 1000 ms.  After every finished      **
+**                       depth an "info" line is sent:                   **
+**                         info depth D score S nodes N nps R time T pv C..**
+**                       S is the goodness for the player to move, or    **
+**                       "win P" / "loss P" when the game is decided     **
+**                       within P plies.  The search ends with           **
+**                         bestmove C [ponder C]                          **
+**                       or "bestmove none" if no piece can be dropped.  **
+**                       "infinite" and "ponder" searches do not send    **
+**                       bestmove before "stop" (or "ponderhit").        **
+**  stop                 end the search now and send bestmove.           **
+**  ponderhit            the pondered move was played: the limits given  **
+**                       to "go ponder" start to count from now.         **
+**  set threads N        search with N threads.                          **
+**  set hash MB          use an MB megabyte transposition table.         **
+**  isready              answered by "readyok".                          **
+**  quit                 end the program.                                **
+**                                                                        **
+**  Errors are answered by a line starting with "error".                  **
+**                                                                        **
+***************************************************************************/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <limits.h>
+#include <threads.h>
+#include <time.h>
+#include "c4.h"
+
+#define SERVER_HASH_MB   256
+#define DEFAULT_MOVETIME 1000
+#define POLL_INTERVAL    (CLOCKS_PER_SEC / 100)
+
+/*   ū goodness а  (INT_MAX -   )̴. */
+#define DECIDED_SCORE (INT_MAX - WIDTH * HEIGHT - 1)
+
+/**
+* Go_options ü go   Ž ̴.
+*/
+
+typedef struct {
+
+	int depth;          	//  ̱ ŽѴ. 0̸ C4_MAX_LEVEL.
+
+	int movetime;       	// Ž ð(и). 0̸ ð  .
+
+	bool infinite;      	// stop   bestmove  ʴ´
+
+	bool ponder;        	// ponderhit̳ stop   bestmove  ʰ, ð  ʴ´
+
+} Go_options;
+
+static c4_ctx *ctx;
+static int moves[WIDTH * HEIGHT], num_moves;	//    column
+static bool finished;       	//  鿡  ̹ ٸ true
+static int num_threads = 1;
+
+static thrd_t search_thread;
+static bool searching;      	// search_thread ִٸ true. main thread Ѵ.
+static atomic_bool stop_requested;
+
+static mtx_t lock;          	// Ʒ  cnd ȣѴ
+static cnd_t wake;          	// stop̳ ponderhit  ٸ search_thread 
+static Go_options go;
+static bool pondering;
+static bool deadline_set;
+static int64_t deadline;     	// monotonic_ns() 
+
+static mtx_t output_lock;   	//  thread    ʰ Ѵ
+
+static void respond(const char *format, ...);
+static bool set_position(const char *text);
+static bool replay(const int *columns, int count);
+static void start_search(char *arguments);
+static void stop_search(void);
+static void ponder_hit(void);
+static int search_main(void *arg);
+static void check_deadline(void);
+static void set_deadline(int movetime);
+static void format_score(char *text, int score);
+static long elapsed_ms(int64_t start);
+static int64_t monotonic_ns(void);
+
+
+
+int
+main(void)
+{
+	char line[1024], *command, *arguments;
+
+	mtx_init(&lock, mtx_plain);
+	mtx_init(&output_lock, mtx_plain);
+	cnd_init(&wake);
+	atomic_init(&stop_requested, false);
+
+	ctx = c4_ctx_new();
+	c4_ctx_set_hash_size(ctx, SERVER_HASH_MB);
+	c4_ctx_poll(ctx, check_deadline, POLL_INTERVAL);
+	c4_ctx_new_game(ctx);
+
+	while (fgets(line, sizeof(line), stdin) != NULL) {
+		line[strcspn(line, "\r\n")] = '\0';
+		command = strtok(line, " \t");
+		if (command == NULL)
+			continue;
+		arguments = strtok(NULL, "");
+		if (arguments == NULL)
+			arguments = "";
+
+		if (strcmp(command, "quit") == 0)
+			break;
+		else if (strcmp(command, "isready") == 0)
+			respond("readyok");
+		else if (strcmp(command, "position") == 0) {
+			stop_search();
+			if (!set_position(arguments))
+				respond("error invalid position %s", arguments);
+		}
+		else if (strcmp(command, "go") == 0) {
+			stop_search();
+			start_search(arguments);
+		}
+		else if (strcmp(command, "stop") == 0)
+			stop_search();
+		else if (strcmp(command, "ponderhit") == 0)
+			ponder_hit();
+		else if (strcmp(command, "set") == 0) {
+			char name[32];
+			int value;
+
+			stop_search();
+			if (sscanf(arguments, "%31s %d", name, &value) != 2)
+				respond("error set needs a name and a value");
+			else if (strcmp(name, "threads") == 0 && value >= 1 && value <= C4_MAX_THREADS) {
+				c4_ctx_set_threads(ctx, value);
+				num_threads = value;
+			}
+			else if (strcmp(name, "hash") == 0 && value >= 0)
+				c4_ctx_set_hash_size(ctx, value);
+			else
+				respond("error invalid option %s", arguments);
+		}
+		else
+			respond("error unknown command %s", command);
+	}
+
+	stop_search();
+	c4_ctx_end_game(ctx);
+	c4_ctx_free(ctx);
+	return 0;
+}
+
+
+
+/**
+* @function respond
+*
+* printf()     ٷ flushѴ.  thread Բ ҷ   ʴ´.
+*/
+
+static void
+respond(const char *format, ...)
+{
+	va_list args;
+
+	mtx_lock(&output_lock);
+	va_start(args, format);
+	vprintf(format, args);
+	va_end(args);
+	putchar('\n');
+	fflush(stdout);
+	mtx_unlock(&output_lock);
+}
+
+
+
+/**
+* @function set_position
+*
+* @param text  忡  column. 1 ,  Ѵ.
+* @return   ִ ̶ true. ƴ϶   ǵ.
+*
+* Ž  ƴ  θ.
+*/
+
+static bool
+set_position(const char *text)
+{
+	int parsed[WIDTH * HEIGHT], height[WIDTH] = { 0 }, count = 0, column;
+
+	for (; *text != '\0'; text++) {
+		if (*text == ' ' || *text == '\t')
+			continue;
+		column = *text - '1';
+		if (column < 0 || column >= WIDTH || height[column] == HEIGHT)
+			return false;
+		height[column]++;
+		parsed[count++] = column;
+	}
+
+	if (!replay(parsed, count)) {
+		replay(moves, num_moves);
+		return false;
+	}
+	memcpy(moves, parsed, count * sizeof(int));
+	num_moves = count;
+	return true;
+}
+
+
+
+/**
+* @function replay
+*
+* @param columns  column
+* @param count columns 
+* @return  Ҵٸ true,   ڿ   ߴٸ false
+*
+* ctx   ϰ columns player 0  ´.  column     row Ѵ.
+*/
+
+static bool
+replay(const int *columns, int count)
+{
+	int height[WIDTH] = { 0 }, i;
+
+	c4_ctx_end_game(ctx);
+	c4_ctx_new_game(ctx);
+	finished = false;
+	for (i = 0; i < count; i++) {
+		if (finished)
+			return false;
+		c4_ctx_make_move(ctx, i & 1, columns[i], height[columns[i]]++);
+		finished = c4_ctx_is_winner(ctx, i & 1) || c4_ctx_is_tie(ctx);
+	}
+	return true;
+}
+
+
+
+/**
+* @function start_search
+*
+* @param arguments go   
+*
+* Ž  о search_thread Ѵ.  ̹  ̶ ٷ "bestmove none" .
+*/
+
+static void
+start_search(char *arguments)
+{
+	Go_options options = { 0 };
+	char *word, *value;
+
+	for (word = strtok(arguments, " \t"); word != NULL; word = strtok(NULL, " \t")) {
+		if (strcmp(word, "infinite") == 0)
+			options.infinite = true;
+		else if (strcmp(word, "ponder") == 0)
+			options.ponder = true;
+		else if ((strcmp(word, "depth") == 0 || strcmp(word, "movetime") == 0) && (value = strtok(NULL, " \t")) != NULL) {
+			if (word[0] == 'd')
+				options.depth = atoi(value);
+			else
+				options.movetime = atoi(value);
+		}
+		else {
+			respond("error invalid go option %s", word);
+			return;
+		}
+	}
+	if (options.depth < 0 || options.depth > C4_MAX_LEVEL || options.movetime < 0) {
+		respond("error go needs depth 1-%d and a positive movetime", C4_MAX_LEVEL);
+		return;
+	}
+	if (options.depth == 0 && options.movetime == 0 && !options.infinite)
+		options.movetime = DEFAULT_MOVETIME;
+
+	if (finished) {
+		respond("bestmove none");
+		return;
+	}
+
+	mtx_lock(&lock);
+	go = options;
+	pondering = options.ponder;
+	deadline_set = false;
+	if (!options.ponder && options.movetime > 0)
+		set_deadline(options.movetime);
+	mtx_unlock(&lock);
+
+	atomic_store(&stop_requested, false);
+	if (thrd_create(&search_thread, search_main, NULL) != thrd_success) {
+		respond("error can't create the search thread");
+		return;
+	}
+	searching = true;
+}
+
+
+
+/**
+* @function stop_search
+*
+*   Ž ִٸ ߰ ϰ, bestmove   ٸ.
+* ̹ bestmove   Ž̶ thread Ѵ.
+*/
+
+static void
+stop_search(void)
+{
+	if (!searching)
+		return;
+
+	mtx_lock(&lock);
+	atomic_store(&stop_requested, true);
+	cnd_signal(&wake);
+	mtx_unlock(&lock);
+	c4_ctx_stop(ctx);
+
+	thrd_join(search_thread, NULL);
+	searching = false;
+}
+
+
+
+/**
+* @function ponder_hit
+*
+* ponder  Ž  Ž ٲ۴. movetime ݺ .
+*/
+
+static void
+ponder_hit(void)
+{
+	mtx_lock(&lock);
+	if (searching && pondering) {
+		pondering = false;
+		if (go.movetime > 0)
+			set_deadline(go.movetime);
+		cnd_signal(&wake);
+	}
+	mtx_unlock(&lock);
+}
+
+
+
+/**
+* @function search_main
+*
+* @return ׻ 0
+*
+* search_thread ϴ Լ̴.  1  ܰ辿  Žϸ ܰ踶 info (iterative deepening).
+* stop ų ð  Ǿ c4_search() -1 ϸ,   Ž   bestmove .
+* а      Ž ʴ´.
+*/
+
+static int
+search_main(void *arg)
+{
+	int player = num_moves & 1, max_depth, depth, column, score, best_column = -1, i;
+	int pv[WIDTH * HEIGHT], pv_length = 0;
+	char score_text[32], pv_text[3 * WIDTH * HEIGHT];
+	unsigned long nodes = 0;
+	long ms;
+	int64_t start;
+
+	(void)arg;
+	start = monotonic_ns();
+
+	max_depth = (go.depth > 0) ? go.depth : C4_MAX_LEVEL;
+	if (max_depth > WIDTH * HEIGHT - num_moves)
+		max_depth = WIDTH * HEIGHT - num_moves;
+
+	for (depth = 1; depth <= max_depth; depth++) {
+		check_deadline();
+		if (atomic_load(&stop_requested))
+			break;
+		column = c4_ctx_search(ctx, player, depth, &score);
+		if (column < 0)
+			break;
+		for (i = 0; i < num_threads; i++)
+			nodes += c4_ctx_thread_nodes(ctx, i);
+		best_column = column;
+		pv_length = c4_ctx_principal_variation(ctx, player, column, pv, depth);
+
+		pv_text[0] = '\0';
+		for (i = 0; i < pv_length; i++)
+			sprintf(pv_text + strlen(pv_text), " %d", pv[i] + 1);
+		format_score(score_text, score);
+		ms = elapsed_ms(start);
+		respond("info depth %d score %s nodes %lu nps %lu time %ld pv%s",
+			depth, score_text, nodes, (ms > 0) ? (unsigned long)(nodes * 1000.0 / ms) : nodes, ms, pv_text);
+
+		if (score > DECIDED_SCORE || score < -DECIDED_SCORE)
+			break;
+	}
+
+	/*  1  ߴٸ   column   ִ  . */
+	if (best_column < 0) {
+		int height[WIDTH] = { 0 };
+
+		for (i = 0; i < num_moves; i++)
+			height[moves[i]]++;
+		for (i = 0; i < WIDTH && best_column < 0; i++) {
+			column = WIDTH / 2 + ((i & 1) ? (i + 1) / 2 : -(i / 2));
+			if (height[column] < HEIGHT)
+				best_column = column;
+		}
+		pv_length = 0;
+	}
+
+	/* infinite ponder Ž  stop̳ ponderhit ٸ. */
+	mtx_lock(&lock);
+	while ((go.infinite || pondering) && !atomic_load(&stop_requested))
+		cnd_wait(&wake, &lock);
+	mtx_unlock(&lock);
+
+	if (pv_length >= 2)
+		respond("bestmove %d ponder %d", best_column + 1, pv[1] + 1);
+	else
+		respond("bestmove %d", best_column + 1);
+	return 0;
+}
+
+
+
+/**
+* @function check_deadline
+*
+* c4_poll()  Ž ߿ ֱ Ҹ. stop ԰ų movetime ٸ Ž .
+* stop_search() θ c4_stop() c4_search() ۵Ǳ ̶ õ  Ƿ, ⼭ ٽ θ.
+*/
+
+static void
+check_deadline(void)
+{
+	bool expired;
+
+	if (atomic_load(&stop_requested)) {
+		c4_ctx_stop(ctx);
+		return;
+	}
+
+	mtx_lock(&lock);
+	expired = deadline_set && monotonic_ns() >= deadline;
+	mtx_unlock(&lock);
+
+	if (expired) {
+		atomic_store(&stop_requested, true);
+		c4_ctx_stop(ctx);
+	}
+}
+
+
+
+/**
+* @function set_deadline
+*
+* @param movetime ݺ Ž ð(и)
+*
+* lock  ä θ.
+*/
+
+static void
+set_deadline(int movetime)
+{
+	deadline = monotonic_ns() + (int64_t)movetime * 1000000;
+	deadline_set = true;
+}
+
+
+
+/**
+* @function format_score
+*
+* @param text   ڿ
+* @param score c4_search()  goodness
+*
+* а  goodness "win P" "loss P",   ״ . P    ̴.
+*/
+
+static void
+format_score(char *text, int score)
+{
+	if (score > DECIDED_SCORE)
+		sprintf(text, "win %d", INT_MAX - score);
+	else if (score < -DECIDED_SCORE)
+		sprintf(text, "loss %d", INT_MAX + score);
+	else
+		sprintf(text, "%d", score);
+}
+
+
+
+/**
+* @function elapsed_ms
+*
+* @return start ݱ 帥 ð(и)
+*/
+
+static long
+elapsed_ms(int64_t start)
+{
+	return (long)((monotonic_ns() - start) / 1000000);
+}
+
+
+
+/**
+* @function monotonic_ns
+*
+* @return   ð 帥 ð(ns). ý ð踦 ٲپ Ųٷ  ʴ´.
+*
+* c4.c  POSIX CLOCK_MONOTONIC , ٸ C11 timespec_get() .
+*/
+
+static int64_t
+monotonic_ns(void)
+{
+	struct timespec now;
+
+#if defined(CLOCK_MONOTONIC)
+	clock_gettime(CLOCK_MONOTONIC, &now);
+#elif defined(TIME_MONOTONIC)
+	timespec_get(&now, TIME_MONOTONIC);
+#else
+	timespec_get(&now, TIME_UTC);
+#endif
+	return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
@@ -0,0 +1,417 @@
+/***************************************************************************
+**                                                                        **
+**                      Connect-4 Engine Tournament                       **
+**                                                                        **
+****************************************************************************
+**                                                                        **
+**  Plays many games between two engines, several games at a time, and    **
+**  reports how the first engine did against the second.                  **
+**                                                                        **
+**  usage: tournament <A> <B> [games [threads [plies [seed]]]]            **
+**                                                                        **
+**  An engine is "depth:N" (search N plies), "time:MS" (iterative         **
+**  deepening for MS milliseconds per move) or "rule" (the rule-based     **
+**  player).  The default is 1000 games on 4 threads.                     **
+**                                                                        **
+**  Every game starts from an opening of <plies> random moves (default    **
+**  4) that does not already decide the game.  Games are played in pairs  **
+**  on the same opening with the colours swapped, so neither engine       **
+**  profits from a lucky opening.  The same seed gives the same openings. **
+**                                                                        **
+**  The report gives A's wins, draws and losses, A's score with its 95%   **
+**  confidence interval and the Elo difference it means, and for each     **
+**  engine the time and the nodes it used per move.                       **
+**                                                                        **
+**  The "time" budget is wall-clock time, so use no more threads than     **
+**  there are cores when an engine is limited by time.                    **
+**                                                                        **
+***************************************************************************/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <threads.h>
+#include <math.h>
+#include <time.h>
+#include "c4.h"
+
+#define TOURNAMENT_HASH_MB   4
+#define TOURNAMENT_MAX_THREADS 256
+#define DEFAULT_GAMES   1000
+#define DEFAULT_THREADS 4
+#define DEFAULT_PLIES   4
+
+#define ENGINE_DEPTH 0
+#define ENGINE_TIME  1
+#define ENGINE_RULE  2
+
+#define RESULT_WIN  0
+#define RESULT_DRAW 1
+#define RESULT_LOSS 2
+
+/**
+* Engine ü 뱹  engine ϳ  ݱ ̴.
+*/
+
+typedef struct {
+
+	const char *name;   	// ٿ  ̸
+
+	int kind;           	// ENGINE_DEPTH, ENGINE_TIME, ENGINE_RULE
+
+	int limit;          	// Ž  Ǵ    ð(и)
+
+	unsigned long moves;	// Ʒ  lock ȣѴ
+
+	unsigned long nodes;
+
+	double ms;
+
+} Engine;
+
+static Engine engines[2];	// 0 A, 1 B
+static int num_games, num_plies;
+static uint64_t seed;
+
+static atomic_int next_game;
+static mtx_t lock;
+static unsigned long results[2][3];	// [A  ξٸ 0][A RESULT_...]
+
+static bool parse_engine(Engine *engine, const char *name);
+static int play_games(void *arg);
+static int play_game(c4_ctx *ctx[2], int game);
+static void random_opening(c4_ctx *ctx, int pair, int *columns);
+static uint64_t next_random(uint64_t *state);
+static double elapsed_ms(const struct timespec *start);
+static double elo(double score);
+static void report(int threads, double ms);
+
+
+
+int
+main(int argc, char *argv[])
+{
+	thrd_t workers[TOURNAMENT_MAX_THREADS];
+	int threads = DEFAULT_THREADS, i;
+	struct timespec start;
+
+	if (argc < 3 || argc > 7) {
+		fprintf(stderr, "usage: %s <engine A> <engine B> [games [threads [plies [seed]]]]\n", argv[0]);
+		fprintf(stderr, "       an engine is depth:1-%d, time:<ms> or rule\n", C4_MAX_LEVEL);
+		return 2;
+	}
+	for (i = 0; i < 2; i++) {
+		if (!parse_engine(&engines[i], argv[1 + i])) {
+			fprintf(stderr, "%s: engine must be depth:1-%d, time:<ms> or rule, not %s.\n", argv[0], C4_MAX_LEVEL, argv[1 + i]);
+			return 2;
+		}
+	}
+	num_games = argc >= 4 ? atoi(argv[3]) : DEFAULT_GAMES;
+	if (argc >= 5)
+		threads = atoi(argv[4]);
+	num_plies = argc >= 6 ? atoi(argv[5]) : DEFAULT_PLIES;
+	seed = argc >= 7 ? strtoull(argv[6], NULL, 10) : (uint64_t)time(NULL);
+	if (num_games < 1 || threads < 1 || threads > TOURNAMENT_MAX_THREADS || num_plies < 0 || num_plies > WIDTH * HEIGHT / 2) {
+		fprintf(stderr, "%s: games must be at least 1, threads 1-%d and plies 0-%d.\n", argv[0], TOURNAMENT_MAX_THREADS, WIDTH * HEIGHT / 2);
+		return 2;
+	}
+	num_games += num_games % 2;	//  opening  Ǿ д
+
+	mtx_init(&lock, mtx_plain);
+	atomic_init(&next_game, 0);
+	timespec_get(&start, TIME_UTC);
+
+	for (i = 0; i < threads; i++) {
+		if (thrd_create(&workers[i], play_games, NULL) != thrd_success) {
+			fprintf(stderr, "%s: can't create thread %d; playing on %d.\n", argv[0], i + 1, i);
+			if (i == 0)
+				return 1;
+			threads = i;
+			break;
+		}
+	}
+	for (i = 0; i < threads; i++)
+		thrd_join(workers[i], NULL);
+
+	report(threads, elapsed_ms(&start));
+	mtx_destroy(&lock);
+	return 0;
+}
+
+
+
+/**
+* @function parse_engine
+*
+* @param engine   Engine
+* @param name "depth:N", "time:MS" Ǵ "rule"
+* @return name ùٸ engine̶ true
+*/
+
+static bool
+parse_engine(Engine *engine, const char *name)
+{
+	memset(engine, 0, sizeof(Engine));
+	engine->name = name;
+	if (sscanf(name, "depth:%d", &engine->limit) == 1 && engine->limit >= 1 && engine->limit <= C4_MAX_LEVEL)
+		engine->kind = ENGINE_DEPTH;
+	else if (sscanf(name, "time:%d", &engine->limit) == 1 && engine->limit >= 1)
+		engine->kind = ENGINE_TIME;
+	else if (strcmp(name, "rule") == 0)
+		engine->kind = ENGINE_RULE;
+	else
+		return false;
+	return true;
+}
+
+
+
+/**
+* @function play_games
+*
+* @return ׻ 0
+*
+* worker thread ü. engine c4_ctx ϳ ,     ϳ ͼ д.
+*  c4_ctx     Ƿ,  engine   ٸ engine c4_ctx ´.
+*/
+
+static int
+play_games(void *arg)
+{
+	c4_ctx *ctx[2];
+	int game, result, i;
+
+	(void)arg;
+	for (i = 0; i < 2; i++) {
+		ctx[i] = c4_ctx_new();
+		c4_ctx_set_hash_size(ctx[i], TOURNAMENT_HASH_MB);
+	}
+
+	while ((game = atomic_fetch_add(&next_game, 1)) < num_games) {
+		result = play_game(ctx, game);
+		mtx_lock(&lock);
+		results[game % 2][result]++;
+		mtx_unlock(&lock);
+	}
+
+	for (i = 0; i < 2; i++)
+		c4_ctx_free(ctx[i]);
+	return 0;
+}
+
+
+
+/**
+* @function play_game
+*
+* @param ctx A B c4_ctx
+* @param game 0   ȣ. ¦ °  A, Ȧ °  B  д.
+* @return A  . RESULT_WIN, RESULT_DRAW, RESULT_LOSS  ϳ
+*
+* game / 2° opening  c4_ctx  ,     engine  д.
+*  engine    ð   engines Ѵ.
+*/
+
+static int
+play_game(c4_ctx *ctx[2], int game)
+{
+	int opening[WIDTH * HEIGHT / 2], height[WIDTH] = { 0 };
+	int player, side, column, row, i, result;
+	unsigned long moves[2] = { 0, 0 }, nodes[2] = { 0, 0 };
+	double ms[2] = { 0, 0 };
+	struct timespec start;
+
+	random_opening(ctx[0], game / 2, opening);
+	for (i = 0; i < 2; i++)
+		c4_ctx_new_game(ctx[i]);
+	for (player = 0; player < num_plies; player++) {
+		column = opening[player];
+		for (i = 0; i < 2; i++)
+			c4_ctx_make_move(ctx[i], player & 1, column, height[column]);
+		height[column]++;
+	}
+
+	/* side   engine. ¦ ° ӿ A(0) player 0̴. */
+	player = num_plies & 1;
+	side = (game + player) & 1;
+	result = RESULT_DRAW;
+	while (!c4_ctx_is_tie(ctx[0])) {
+		timespec_get(&start, TIME_UTC);
+		switch (engines[side].kind) {
+		case ENGINE_DEPTH:
+			c4_ctx_auto_move(ctx[side], player, engines[side].limit, &column, &row);
+			nodes[side] += c4_ctx_thread_nodes(ctx[side], 0);
+			break;
+		case ENGINE_TIME:
+			c4_ctx_auto_move_timed(ctx[side], player, engines[side].limit, &column, &row);
+			nodes[side] += c4_ctx_thread_nodes(ctx[side], 0);
+			break;
+		default:
+			c4_ctx_rule_auto_move(ctx[side], player, &column, &row);
+			break;
+		}
+		ms[side] += elapsed_ms(&start);
+		moves[side]++;
+		c4_ctx_make_move(ctx[!side], player, column, row);
+
+		if (c4_ctx_is_winner(ctx[side], player)) {
+			result = side == 0 ? RESULT_WIN : RESULT_LOSS;
+			break;
+		}
+		player ^= 1;
+		side ^= 1;
+	}
+	for (i = 0; i < 2; i++)
+		c4_ctx_end_game(ctx[i]);
+
+	mtx_lock(&lock);
+	for (i = 0; i < 2; i++) {
+		engines[i].moves += moves[i];
+		engines[i].nodes += nodes[i];
+		engines[i].ms += ms[i];
+	}
+	mtx_unlock(&lock);
+	return result;
+}
+
+
+
+/**
+* @function random_opening
+*
+* @param ctx    c4_ctx.     ϸ, ƿ  .
+* @param pair 0  opening ȣ
+* @param columns num_plies column  迭
+*
+* seed pair   num_plies  .   column  ,
+*  ̿    ̰ٸ ó ٽ .  seed pairδ ׻  opening ´.
+*/
+
+static void
+random_opening(c4_ctx *ctx, int pair, int *columns)
+{
+	uint64_t state = seed ^ ((uint64_t)pair * 0x9E3779B97F4A7C15ULL);
+	int height[WIDTH], ply, column;
+	bool decided;
+
+	do {
+		memset(height, 0, sizeof(height));
+		c4_ctx_new_game(ctx);
+		decided = false;
+		for (ply = 0; ply < num_plies && !decided; ply++) {
+			do
+				column = (int)(next_random(&state) % WIDTH);
+			while (height[column] == HEIGHT);
+			c4_ctx_make_move(ctx, ply & 1, column, height[column]++);
+			columns[ply] = column;
+			decided = c4_ctx_is_winner(ctx, ply & 1);
+		}
+		c4_ctx_end_game(ctx);
+	} while (decided);
+}
+
+
+
+/**
+* @function next_random
+*
+* @param state   
+* @return  64Ʈ 
+*
+* thread    ֵ ¸ ۿ δ splitmix64.
+*/
+
+static uint64_t
+next_random(uint64_t *state)
+{
+	uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+
+
+/**
+* @function elapsed_ms
+*
+* @return start ݱ 帥 ð(и)
+*/
+
+static double
+elapsed_ms(const struct timespec *start)
+{
+	struct timespec now;
+
+	timespec_get(&now, TIME_UTC);
+	return (now.tv_sec - start->tv_sec) * 1000.0 + (now.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+
+
+/**
+* @function elo
+*
+* @param score  Ӵ  . ̱ 1,  0.5,  0
+* @return   Ǵ  engine Elo . score 0̳ 1̸ -INFINITY INFINITY
+*/
+
+static double
+elo(double score)
+{
+	if (score <= 0)
+		return -INFINITY;
+	if (score >= 1)
+		return INFINITY;
+	return 400.0 * log10(score / (1.0 - score));
+}
+
+
+
+/**
+* @function report
+*
+* @param threads   thread 
+* @param ms ü ȸ ɸ ð(и)
+*
+* A //п  stdout .  ŷڱ   ǥл  95% Աٻ̴.
+*/
+
+static void
+report(int threads, double ms)
+{
+	unsigned long win, draw, loss, n;
+	double score, deviation, margin;
+	int i;
+
+	win = results[0][RESULT_WIN] + results[1][RESULT_WIN];
+	draw = results[0][RESULT_DRAW] + results[1][RESULT_DRAW];
+	loss = results[0][RESULT_LOSS] + results[1][RESULT_LOSS];
+	n = win + draw + loss;
+
+	score = (win + draw * 0.5) / n;
+	deviation = (win * (1 - score) * (1 - score) + draw * (0.5 - score) * (0.5 - score) + loss * score * score) / n;
+	margin = 1.96 * sqrt(deviation / n);
+
+	printf("A: %s\nB: %s\n", engines[0].name, engines[1].name);
+	printf("%lu games, %d random plies, seed %llu, %d threads, %.1f s\n",
+		n, num_plies, (unsigned long long)seed, threads, ms / 1000);
+	printf("A wins %lu, draws %lu, losses %lu\n", win, draw, loss);
+	printf("  moving first:  %lu-%lu-%lu\n", results[0][RESULT_WIN], results[0][RESULT_DRAW], results[0][RESULT_LOSS]);
+	printf("  moving second: %lu-%lu-%lu\n", results[1][RESULT_WIN], results[1][RESULT_DRAW], results[1][RESULT_LOSS]);
+	printf("A score %.3f +- %.3f (95%%), Elo %+.0f [%+.0f, %+.0f]\n",
+		score, margin, elo(score), elo(score - margin), elo(score + margin));
+	for (i = 0; i < 2; i++) {
+		printf("%c: %lu moves, %.3f ms/move", 'A' + i, engines[i].moves,
+			engines[i].moves > 0 ? engines[i].ms / engines[i].moves : 0.0);
+		if (engines[i].kind != ENGINE_RULE)
+			printf(", %.0f nodes/move", engines[i].moves > 0 ? (double)engines[i].nodes / engines[i].moves : 0.0);
+		printf("\n");
+	}
+}